@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2018 Diogo Haruki Kykuta
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+*/
+#include "compressedadjacency.hpp"
+
+#include <unordered_map>
+
+namespace haruki
+{
+
+/* largest dictionary addressed by 2 byte codes */
+static const size_t kMaxCostDictionary = 1 << 16;
+
+static void writeVarint(HugeVector<uint8_t> &bytes, unsigned int x)
+{
+  while (x >= 0x80)
+  {
+    bytes.push_back((uint8_t)(x | 0x80));
+    x >>= 7;
+  }
+  bytes.push_back((uint8_t)x);
+}
+
+CompressedAdjacency::CompressedAdjacency(Span<const EdgeIdx> firstEdgeEachV, Span<const int> heads, Span<const Weight> costs, int numVert, EdgeIdx numEdges)
+{
+  firstByteEachV_ = std::vector<size_t>(numVert);
+  headBytes_.reserve(numEdges + numEdges / 2);
+  for (int v = 0; v < numVert; v++)
+  {
+    firstByteEachV_[v] = headBytes_.size();
+    EdgeIdx endIdx = (v + 1 < numVert ? firstEdgeEachV[v + 1] : numEdges);
+    for (EdgeIdx idx = firstEdgeEachV[v]; idx < endIdx; idx++)
+    {
+      if (idx == firstEdgeEachV[v])
+      {
+        int diff = heads[idx] - v;
+        writeVarint(headBytes_, ((unsigned int)diff << 1) ^ (unsigned int)(diff >> 31));
+      }
+      else
+      {
+        writeVarint(headBytes_, heads[idx] - heads[idx - 1]);
+      }
+    }
+  }
+  headBytes_.shrink_to_fit();
+
+  costCodeBytes_ = 0;
+  std::unordered_map<Weight, int> codeOf;
+  for (EdgeIdx idx = 0; idx < numEdges && codeOf.size() <= kMaxCostDictionary; idx++)
+  {
+    if (codeOf.find(costs[idx]) == codeOf.end())
+    {
+      int code = codeOf.size();
+      codeOf[costs[idx]] = code;
+    }
+  }
+  if (codeOf.size() > kMaxCostDictionary)
+  {
+    return;
+  }
+
+  costDictionary_ = std::vector<Weight>(codeOf.size());
+  for (auto it = codeOf.begin(); it != codeOf.end(); ++it)
+  {
+    costDictionary_[it->second] = it->first;
+  }
+  costCodeBytes_ = (codeOf.size() <= 256 ? 1 : 2);
+  costCodes_ = HugeVector<uint8_t>((size_t)numEdges * costCodeBytes_);
+  for (EdgeIdx idx = 0; idx < numEdges; idx++)
+  {
+    int code = codeOf[costs[idx]];
+    if (costCodeBytes_ == 1)
+    {
+      costCodes_[idx] = code;
+    }
+    else
+    {
+      costCodes_[2 * (size_t)idx] = code & 0xff;
+      costCodes_[2 * (size_t)idx + 1] = code >> 8;
+    }
+  }
+}
+
+EdgeIdx CompressedAdjacency::find(int tail, int head, EdgeIdx firstIdx, EdgeIdx endIdx) const
+{
+  if (firstIdx >= endIdx)
+  {
+    return -1;
+  }
+  const uint8_t *p = headBytes(tail);
+  int h = readFirstHead(p, tail);
+  for (EdgeIdx idx = firstIdx;; idx++)
+  {
+    if (h >= head)
+    {
+      return h == head ? idx : -1;
+    }
+    if (idx + 1 >= endIdx)
+    {
+      return -1;
+    }
+    h += readVarint(p);
+  }
+}
+
+void CompressedAdjacency::decodeHeads(Span<const EdgeIdx> firstEdgeEachV, int numVert, EdgeIdx numEdges, HugeVector<int> &heads) const
+{
+  heads = HugeVector<int>(numEdges);
+  const uint8_t *p = headBytes_.data();
+  for (int v = 0; v < numVert; v++)
+  {
+    EdgeIdx endIdx = (v + 1 < numVert ? firstEdgeEachV[v + 1] : numEdges);
+    for (EdgeIdx idx = firstEdgeEachV[v]; idx < endIdx; idx++)
+    {
+      heads[idx] = (idx == firstEdgeEachV[v] ? readFirstHead(p, v) : heads[idx - 1] + (int)readVarint(p));
+    }
+  }
+}
+
+void CompressedAdjacency::decodeCosts(EdgeIdx numEdges, HugeVector<Weight> &costs) const
+{
+  costs = HugeVector<Weight>(numEdges);
+  for (EdgeIdx idx = 0; idx < numEdges; idx++)
+  {
+    costs[idx] = cost(idx);
+  }
+}
+
+size_t CompressedAdjacency::memoryBytes() const
+{
+  return headBytes_.capacity() + firstByteEachV_.capacity() * sizeof(size_t)
+      + costDictionary_.capacity() * sizeof(Weight) + costCodes_.capacity();
+}
+}
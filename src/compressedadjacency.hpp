@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2018 Diogo Haruki Kykuta
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "span.hpp"
+#include "weight.hpp"
+#include "edgeidx.hpp"
+#include "hugepage.hpp"
+
+namespace haruki
+{
+
+/*
+ * Forward adjacency of a graph in compressed form.
+ *
+ * The heads of each adjacency are stored as LEB128 varints: the first one
+ * as the zigzag coded difference to the tail, the others as the difference
+ * to the previous head, which is never negative as adjacencies are sorted.
+ * Costs are replaced by 1 or 2 byte codes into a dictionary when the graph
+ * has at most 65536 distinct costs, which keeps them lossless; otherwise
+ * they are left to the caller (hasCostCodes() is false).
+ *
+ * Edge indices are unchanged, so removal masks and cost overlays work the
+ * same on a compressed graph.
+ */
+class CompressedAdjacency
+{
+private:
+  HugeVector<uint8_t> headBytes_;
+  std::vector<size_t> firstByteEachV_;
+  std::vector<Weight> costDictionary_;
+  HugeVector<uint8_t> costCodes_;
+  int costCodeBytes_;
+
+public:
+  CompressedAdjacency(Span<const EdgeIdx> firstEdgeEachV, Span<const int> heads, Span<const Weight> costs, int numVert, EdgeIdx numEdges);
+
+  static unsigned int readVarint(const uint8_t *&p)
+  {
+    unsigned int x = *p++;
+    if (x < 0x80)
+    {
+      return x;
+    }
+    x &= 0x7f;
+    int shift = 7;
+    uint8_t b;
+    do
+    {
+      b = *p++;
+      x |= (unsigned int)(b & 0x7f) << shift;
+      shift += 7;
+    } while (b & 0x80);
+    return x;
+  }
+
+  /* first head of the adjacency of tail, p must point at its bytes */
+  static int readFirstHead(const uint8_t *&p, int tail)
+  {
+    unsigned int z = readVarint(p);
+    return tail + (int)((z >> 1) ^ -(z & 1));
+  }
+
+  const uint8_t *headBytes(int v) const { return headBytes_.data() + firstByteEachV_[v]; }
+  bool hasCostCodes() const { return costCodeBytes_ != 0; }
+
+  Weight cost(EdgeIdx idx) const
+  {
+    if (costCodeBytes_ == 1)
+    {
+      return costDictionary_[costCodes_[idx]];
+    }
+    return costDictionary_[costCodes_[2 * (size_t)idx] | (costCodes_[2 * (size_t)idx + 1] << 8)];
+  }
+
+  /* index of the first edge tail -> head in [firstIdx, endIdx), or -1 */
+  EdgeIdx find(int tail, int head, EdgeIdx firstIdx, EdgeIdx endIdx) const;
+  void decodeHeads(Span<const EdgeIdx> firstEdgeEachV, int numVert, EdgeIdx numEdges, HugeVector<int> &heads) const;
+  void decodeCosts(EdgeIdx numEdges, HugeVector<Weight> &costs) const;
+  size_t memoryBytes() const;
+};
+}
@@ -0,0 +1,220 @@
+/*
+ * Copyright (C) 2018 Diogo Haruki Kykuta
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+*/
+#include "contract.hpp"
+#include <algorithm>
+#include <set>
+#include <vector>
+
+namespace haruki
+{
+namespace contract
+{
+
+/* the end of a chain walked from tail along one of its edges */
+struct Walk
+{
+  int head;
+  std::vector<int> vertices;
+  std::vector<Weight> costs;
+};
+
+static bool isChainVertex(Graph &g, int v)
+{
+  std::vector<int> outs, ins;
+  for (auto it : g.getEdgesOut(v))
+  {
+    outs.push_back(it.head);
+    if (outs.size() > 2)
+    {
+      return false;
+    }
+  }
+  for (auto it : g.getEdgesIn(v))
+  {
+    ins.push_back(it.tail);
+    if (ins.size() > 2)
+    {
+      return false;
+    }
+  }
+  if (outs.size() != ins.size() || outs.empty())
+  {
+    return false;
+  }
+  std::sort(outs.begin(), outs.end());
+  std::sort(ins.begin(), ins.end());
+  if (outs.size() == 1)
+  {
+    return outs[0] != ins[0] && outs[0] != v && ins[0] != v;
+  }
+  return outs == ins && outs[0] != outs[1] && outs[0] != v && outs[1] != v;
+}
+
+/* follows tail -> head and the chain vertices after it up to the next
+ * vertex that is not one */
+static Walk walkChain(Graph &g, const std::vector<char> &inChain, int tail, int head, Weight cost)
+{
+  Walk walk;
+  walk.costs.push_back(cost);
+  int prev = tail;
+  while (inChain[head])
+  {
+    walk.vertices.push_back(head);
+    for (auto it : g.getEdgesOut(head))
+    {
+      if (it.head != prev)
+      {
+        prev = head;
+        head = it.head;
+        walk.costs.push_back(it.cost);
+        break;
+      }
+    }
+  }
+  walk.head = head;
+  return walk;
+}
+
+/* appends the edge tail -> head of g to chain, itself expanded if it
+ * was a shortcut already */
+static void appendEdge(Graph &g, ShortcutTable::Chain &chain, int tail, int head, Weight cost)
+{
+  const ShortcutTable::Chain *inner = g.hasShortcuts()
+      ? g.getShortcuts()->find(g.toOriginalId(tail), g.toOriginalId(head)) : nullptr;
+  if (inner == nullptr)
+  {
+    chain.costs.push_back(cost);
+    return;
+  }
+  chain.vertices.insert(chain.vertices.end(), inner->vertices.begin(), inner->vertices.end());
+  chain.costs.insert(chain.costs.end(), inner->costs.begin(), inner->costs.end());
+}
+
+Graph *contractChains(Graph &g, int s, int t, int numThreads)
+{
+  int numVert = g.getNumVert();
+  std::vector<char> inChain(numVert, 0);
+  for (int v = 0; v < numVert; v++)
+  {
+    inChain[v] = v != s && v != t && isChainVertex(g, v);
+  }
+
+  /* keeps the last vertex of every chain whose edge would be parallel to
+   * another one, until there are none */
+  bool cut = true;
+  while (cut)
+  {
+    cut = false;
+    std::set<std::pair<int, int> > ends;
+    for (int v = 0; v < numVert; v++)
+    {
+      if (inChain[v])
+      {
+        continue;
+      }
+      for (auto it : g.getEdgesOut(v))
+      {
+        if (!inChain[it.head])
+        {
+          continue;
+        }
+        Walk walk = walkChain(g, inChain, v, it.head, it.cost);
+        if (walk.head == v)
+        {
+          continue;
+        }
+        bool parallel = g.hasEdge(v, walk.head) && !g.isRemoved(v, walk.head);
+        if (parallel || !ends.insert(std::make_pair(v, walk.head)).second)
+        {
+          inChain[walk.vertices.back()] = 0;
+          cut = true;
+        }
+      }
+    }
+  }
+
+  std::vector<int> newId(numVert, -1);
+  std::vector<int> originalIds;
+  for (int v = 0; v < numVert; v++)
+  {
+    if (!inChain[v])
+    {
+      newId[v] = originalIds.size();
+      originalIds.push_back(g.toOriginalId(v));
+    }
+  }
+
+  GraphBuilder pg;
+  pg.setNumVert(originalIds.size());
+  std::shared_ptr<ShortcutTable> shortcuts = std::make_shared<ShortcutTable>();
+  for (int v = 0; v < numVert; v++)
+  {
+    if (inChain[v])
+    {
+      continue;
+    }
+    for (auto it : g.getEdgesOut(v))
+    {
+      ShortcutTable::Chain chain;
+      if (!inChain[it.head])
+      {
+        pg.addEdge(newId[v], newId[it.head], it.cost);
+        appendEdge(g, chain, v, it.head, it.cost);
+        if (!chain.vertices.empty())
+        {
+          shortcuts->add(g.toOriginalId(v), g.toOriginalId(it.head), chain);
+        }
+        continue;
+      }
+      /* a chain leading back to v is only walked around in a cycle */
+      Walk walk = walkChain(g, inChain, v, it.head, it.cost);
+      if (walk.head == v)
+      {
+        continue;
+      }
+      Weight cost = 0;
+      int tail = v;
+      for (size_t i = 0; i < walk.costs.size(); i++)
+      {
+        int head = i < walk.vertices.size() ? walk.vertices[i] : walk.head;
+        cost += walk.costs[i];
+        appendEdge(g, chain, tail, head, walk.costs[i]);
+        if (i < walk.vertices.size())
+        {
+          chain.vertices.push_back(g.toOriginalId(head));
+        }
+        tail = head;
+      }
+      pg.addEdge(newId[v], newId[walk.head], cost);
+      shortcuts->add(g.toOriginalId(v), g.toOriginalId(walk.head), chain);
+    }
+  }
+  pg.setOriginalIds(originalIds);
+  if (shortcuts->size() > 0)
+  {
+    pg.setShortcuts(shortcuts);
+  }
+  return new Graph(std::move(pg), numThreads);
+}
+
+}
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2018 Diogo Haruki Kykuta
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+*/
+#pragma once
+
+#include "graph.hpp"
+
+namespace haruki {
+  namespace contract {
+    /*
+     * Builds a copy of g where every chain of degree-2 vertices is replaced
+     * by a single edge, as long as the chain's cost. A vertex is in a
+     * chain when one edge comes in and one goes out, to two other vertices,
+     * or when it has edges to and from the same two other vertices, as on a
+     * two-way road. s and t are never contracted.
+     *
+     * A chain is cut short where its edge would be parallel to another one,
+     * and a chain that leads back to where it started is dropped, so simple
+     * s-t paths map one to one to those of g, with the same costs. Like
+     * reorder::reorderGraph, the copy drops removed edges and remembers the
+     * input ids; its ShortcutTable lets KSP::run expand the paths it finds
+     * back to the vertices of the input.
+     */
+    Graph *contractChains(Graph &g, int s, int t, int numThreads = 0);
+  }
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2018 Diogo Haruki Kykuta
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+*/
+#include "deltaoverlay.hpp"
+
+namespace haruki
+{
+
+EdgeIdx DeltaOverlay::insert(const EdgeInfo &edge)
+{
+  EdgeIdx edgeIdx = baseEdges + numInserted();
+  tails.push_back(edge.tail);
+  heads.push_back(edge.head);
+  costs.push_back(edge.cost);
+  out[edge.tail].push_back(edgeIdx);
+  in[edge.head].push_back(edgeIdx);
+  tombstones.resize(edgeIdx + 1);
+  return edgeIdx;
+}
+
+void DeltaOverlay::erase(EdgeIdx edgeIdx)
+{
+  if (!tombstones[edgeIdx])
+  {
+    tombstones.set(edgeIdx, true);
+    numTombstones++;
+  }
+}
+
+EdgeIdx DeltaOverlay::find(int tail, int head) const
+{
+  const std::vector<EdgeIdx> &inserted = out[tail];
+  for (auto it = inserted.begin(); it != inserted.end(); ++it)
+  {
+    if (heads[*it - baseEdges] == head && !tombstones[*it])
+    {
+      return *it;
+    }
+  }
+  return -1;
+}
+
+size_t DeltaOverlay::memoryBytes() const
+{
+  size_t bytes = (tails.capacity() + heads.capacity()) * sizeof(int)
+      + costs.capacity() * sizeof(Weight)
+      + (out.capacity() + in.capacity()) * sizeof(std::vector<EdgeIdx>)
+      + (tombstones.size() + 63) / 64 * (sizeof(uint64_t) + sizeof(unsigned int));
+  for (size_t v = 0; v < out.size(); v++)
+  {
+    bytes += (out[v].capacity() + in[v].capacity()) * sizeof(EdgeIdx);
+  }
+  return bytes;
+}
+}
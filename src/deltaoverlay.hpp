@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2018 Diogo Haruki Kykuta
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include "graphaux.hpp"
+#include "edgemask.hpp"
+
+namespace haruki
+{
+
+/*
+ * Edges inserted into and deleted from a graph after its CSR was built.
+ *
+ * Inserted edge i gets the index baseEdges + i, after the edges of the
+ * topology, and is listed in out[tail] and in[head]. Deleted edges, from
+ * the topology or inserted, are flagged in tombstones, which every removal
+ * mask of the graph is layered on (see EdgeMask::setBase()).
+ *
+ * Like the topology, an overlay is shared between copies of a graph and
+ * copied before being changed while shared (see Graph::insertEdges()).
+ */
+struct DeltaOverlay
+{
+  EdgeIdx baseEdges;
+  std::vector<int> tails;
+  std::vector<int> heads;
+  std::vector<Weight> costs;
+  std::vector<std::vector<EdgeIdx> > out;
+  std::vector<std::vector<EdgeIdx> > in;
+  EdgeMask tombstones;
+  EdgeIdx numTombstones;
+
+  DeltaOverlay(int numVert, EdgeIdx baseEdges)
+      : baseEdges(baseEdges), out(numVert), in(numVert),
+        tombstones(baseEdges, false), numTombstones(0) {}
+
+  EdgeIdx numInserted() const { return tails.size(); }
+  /* inserted edges plus tombstones, what a compaction would fold */
+  EdgeIdx size() const { return numInserted() + numTombstones; }
+
+  EdgeIdx insert(const EdgeInfo &edge);
+  void erase(EdgeIdx edgeIdx);
+  /* first inserted edge (tail, head) not deleted, or -1 */
+  EdgeIdx find(int tail, int head) const;
+  size_t memoryBytes() const;
+};
+}
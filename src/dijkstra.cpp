@@ -37,14 +37,14 @@ namespace haruki
 {
 namespace dijkstra
 {
-typedef std::pair<double, int> pairVertCost;
+typedef std::pair<Weight, int> pairVertCost;
 
-Path buildPathFromParents(Graph &g, std::vector<int> parents, int s, int t);
+Path buildPathFromParents(Graph &g, const HugeVector<int> &parents, int s, int t);
 
 Path minPath(Graph &g, int s, int t)
 {
-  std::vector<int> parents;
-  std::vector<double> distances;
+  HugeVector<int> parents;
+  HugeVector<Weight> distances;
 
 #ifdef HRK_COUNT_
   hrk_dijkstra_count++;
@@ -54,11 +54,29 @@ Path minPath(Graph &g, int s, int t)
   return buildPathFromParents(g, parents, s, t);
 }
 
-void dijkstra_parents(Graph &g, int s, int t, bool stopFound, std::vector<int>& parents, std::vector<double>& distances)
+/* searches follow the edges out of each vertex, or into it on the transpose */
+struct Forward
 {
-  std::vector<int> frj(g.getNumVert(), -1);
+  typedef EdgeOut::range range;
+  typedef EdgeOut::iterator iterator;
+  static range edges(Graph &g, int v) { return g.getEdgesOut(v); }
+  static int next(const iterator &it) { return it.head(); }
+};
 
-  std::set< std::pair<double, int> > pq;
+struct Backward
+{
+  typedef EdgeIn::range range;
+  typedef EdgeIn::iterator iterator;
+  static range edges(Graph &g, int v) { return g.getEdgesIn(v); }
+  static int next(const iterator &it) { return it.tail(); }
+};
+
+template <typename Direction>
+static void search(Graph &g, int s, int t, bool stopFound, HugeVector<int>& parents, HugeVector<Weight>& distances)
+{
+  HugeVector<int> frj(g.getNumVert(), -1);
+
+  std::set< std::pair<Weight, int> > pq;
 
   parents.resize(g.getNumVert(), -1);
   distances.resize(g.getNumVert(), -1);
@@ -66,18 +84,18 @@ void dijkstra_parents(Graph &g, int s, int t, bool stopFound, std::vector<int>&
 
   parents[s] = s;
   distances[s] = 0.0;
-  EdgeOut::range edges = g.getEdgesOut(s);
-  for (EdgeOut::iterator it = edges.begin(); it != edges.end(); ++it) {
-    int v = (*it).head;
-    distances[v] = (*it).cost;
+  typename Direction::range edges = Direction::edges(g, s);
+  for (typename Direction::iterator it = edges.begin(); it != edges.end(); ++it) {
+    int v = Direction::next(it);
+    distances[v] = it.cost();
     pq.emplace(distances[v], v);
     frj[v] = s;
   }
 
   while (!pq.empty())
   {
-    std::set<std::pair<double, int> >::iterator it = pq.begin();
-    std::pair<double, int> elem = *it;
+    std::set<std::pair<Weight, int> >::iterator it = pq.begin();
+    std::pair<Weight, int> elem = *it;
     pq.erase(it);
     int w = elem.second;
     if (parents[w] != -1)
@@ -90,17 +108,17 @@ void dijkstra_parents(Graph &g, int s, int t, bool stopFound, std::vector<int>&
       break;
     }
 
-    EdgeOut::range edges2 = g.getEdgesOut(w);
-    for (EdgeOut::iterator it = edges2.begin(); it != edges2.end(); ++it) {
-      int v = (*it).head;
+    typename Direction::range edges2 = Direction::edges(g, w);
+    for (typename Direction::iterator it = edges2.begin(); it != edges2.end(); ++it) {
+      int v = Direction::next(it);
       if (parents[v] != -1)
       {
         continue;
       }
-      double newdist = distances[w] + (*it).cost;
+      Weight newdist = distances[w] + it.cost();
       if (frj[v] == -1 || newdist < distances[v])
       {
-        auto x = pq.find(std::pair<double, int>(distances[v], v));
+        auto x = pq.find(std::pair<Weight, int>(distances[v], v));
         if (x != pq.end()) {
           pq.erase(x);
         }
@@ -112,7 +130,17 @@ void dijkstra_parents(Graph &g, int s, int t, bool stopFound, std::vector<int>&
   }
 }
 
-Path buildPathFromParents(Graph &g, std::vector<int> parents, int s, int t) {
+void dijkstra_parents(Graph &g, int s, int t, bool stopFound, HugeVector<int>& parents, HugeVector<Weight>& distances)
+{
+  search<Forward>(g, s, t, stopFound, parents, distances);
+}
+
+void dijkstra_parents_reverse(Graph &g, int s, int t, bool stopFound, HugeVector<int>& parents, HugeVector<Weight>& distances)
+{
+  search<Backward>(g, s, t, stopFound, parents, distances);
+}
+
+Path buildPathFromParents(Graph &g, const HugeVector<int> &parents, int s, int t) {
   if (s == t) {
     return Path();
   }
@@ -22,10 +22,14 @@
 #pragma once
 
 #include <vector>
+#include "weight.hpp"
+#include "hugepage.hpp"
 
 namespace haruki {
   namespace dijkstra {
     Path minPath(Graph &g, int s, int t);
-    void dijkstra_parents(Graph &g, int s, int t, bool stopFound, std::vector<int>& parents, std::vector<double>& distances);
+    void dijkstra_parents(Graph &g, int s, int t, bool stopFound, HugeVector<int>& parents, HugeVector<Weight>& distances);
+    /* same search on the transpose of g, following the edges into each vertex */
+    void dijkstra_parents_reverse(Graph &g, int s, int t, bool stopFound, HugeVector<int>& parents, HugeVector<Weight>& distances);
   }
 }
@@ -24,10 +24,17 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
-#include <set>
 #include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include <utility>
 
 #include "graph.hpp"
+#include "mappedfile.hpp"
+#include "parallel.hpp"
 
 namespace haruki
 {
@@ -36,16 +43,45 @@ namespace dimacs
 
 using std::string;
 
-Graph *readGrFile(std::string filepath)
+bool parseRepeatedEdges(const std::string &name, RepeatedEdges &repeated)
+{
+  if (name == "all")
+  {
+    repeated = KEEP_ALL_REPEATED;
+  }
+  else if (name == "first")
+  {
+    repeated = KEEP_FIRST_REPEATED;
+  }
+  else if (name == "min")
+  {
+    repeated = KEEP_MIN_COST_REPEATED;
+  }
+  else
+  {
+    return false;
+  }
+  return true;
+}
+
+Graph *readGrFile(std::string filepath, RepeatedEdges repeated)
 {
-  int n, m;
-  string line;
-  std::ifstream myfile;
-  Graph *g = nullptr;
   GraphBuilder pg;
+  if (!readGrFile(filepath, pg, repeated))
+  {
+    return nullptr;
+  }
+  return new Graph(std::move(pg));
+}
 
-  std::set<std::pair<int,int> > edgesAdded;
+bool readGrFile(std::string filepath, GraphBuilder &pg, RepeatedEdges repeated)
+{
+  int n;
+  EdgeIdx m;
+  string line;
+  std::ifstream myfile;
 
+  pg.setRepeatedEdges(repeated);
   myfile.open(filepath);
 
   if (myfile.is_open())
@@ -54,7 +90,8 @@ Graph *readGrFile(std::string filepath)
     {
       std::stringstream lstream(line);
       char id;
-      int u, v, w;
+      int u, v;
+      Weight w;
       string aux;
       lstream >> id;
       switch (id)
@@ -66,25 +103,423 @@ Graph *readGrFile(std::string filepath)
         break;
       case 'a':
         lstream >> u >> v >> w;
-        if (edgesAdded.find(std::pair<int,int>(u, v)) != edgesAdded.end()) {
-          continue;
-        }
         pg.addEdge(u-1, v-1, w);
-        edgesAdded.insert(std::pair<int,int>(u, v));
       case 'c':
       default:
         continue;
       }
     }
     myfile.close();
-    g = new Graph(pg);
   }
   else
   {
     std::cout << "it's closed" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+/*
+ * Cursor over the text of a .gr file, read in place: no value is read past
+ * the end of its line and nothing is allocated.
+ */
+class Scanner
+{
+private:
+  const char *p_;
+  const char *end_;
+
+  static bool isBlank(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f'; }
+  void skipBlanks()
+  {
+    while (p_ < end_ && isBlank(*p_))
+    {
+      p_++;
+    }
+  }
+
+public:
+  Scanner(const char *begin, const char *end) : p_(begin), end_(end) {}
+
+  bool atEnd() const { return p_ >= end_; }
+  const char *position() const { return p_; }
+
+  /* first character of the line that is not blank, 0 on an empty line */
+  char lineType()
+  {
+    skipBlanks();
+    return p_ < end_ && *p_ != '\n' ? *p_++ : 0;
+  }
+
+  void nextLine()
+  {
+    const void *newline = memchr(p_, '\n', end_ - p_);
+    p_ = newline ? static_cast<const char *>(newline) + 1 : end_;
+  }
+
+  void skipWord()
+  {
+    skipBlanks();
+    while (p_ < end_ && !isBlank(*p_) && *p_ != '\n')
+    {
+      p_++;
+    }
+  }
+
+  bool readInteger(long long &value)
+  {
+    skipBlanks();
+    bool negative = p_ < end_ && *p_ == '-';
+    if (p_ < end_ && (*p_ == '-' || *p_ == '+'))
+    {
+      p_++;
+    }
+    if (p_ >= end_ || *p_ < '0' || *p_ > '9')
+    {
+      return false;
+    }
+    value = 0;
+    while (p_ < end_ && *p_ >= '0' && *p_ <= '9')
+    {
+      value = value * 10 + (*p_ - '0');
+      p_++;
+    }
+    if (negative)
+    {
+      value = -value;
+    }
+    return true;
+  }
+
+  /* integer costs are decoded by hand, those with a fraction or an
+   * exponent (only read into a floating point Weight) go through strtod */
+  bool readWeight(Weight &weight)
+  {
+    skipBlanks();
+    const char *start = p_;
+    long long value;
+    bool integer = readInteger(value);
+    if (std::is_floating_point<Weight>::value && (!integer || (p_ < end_ && (*p_ == '.' || *p_ == 'e' || *p_ == 'E'))))
+    {
+      char token[64];
+      size_t length = 0;
+      p_ = start;
+      while (p_ < end_ && !isBlank(*p_) && *p_ != '\n' && length + 1 < sizeof(token))
+      {
+        token[length++] = *p_++;
+      }
+      token[length] = 0;
+      char *stop;
+      weight = static_cast<Weight>(strtod(token, &stop));
+      return stop != token;
+    }
+    weight = static_cast<Weight>(value);
+    return integer;
+  }
+};
+
+/* below this size a file is parsed on the calling thread */
+static const size_t kParallelParseMinBytes = 1 << 20;
+
+/* what one thread read from the lines starting in its chunk of the file */
+struct ChunkEdges
+{
+  std::vector<EdgeInfo> edges;
+  long long numVert = -1;
+  long long numEdges = -1;
+  long long maxVertex = -1;
+};
+
+/* calls onHeader(n, m) and onArc(u, v, w), ids as in the file, for the
+ * lines of [begin, end) widened to whole lines: a line belongs to the
+ * chunk where it starts */
+template <class OnHeader, class OnArc>
+static void scanChunk(const char *fileBegin, const char *fileEnd, const char *begin, const char *end, OnHeader onHeader, OnArc onArc)
+{
+  if (begin != fileBegin && begin[-1] != '\n')
+  {
+    const void *newline = memchr(begin, '\n', fileEnd - begin);
+    begin = newline ? static_cast<const char *>(newline) + 1 : fileEnd;
+  }
+
+  Scanner in(begin, fileEnd);
+  while (in.position() < end && !in.atEnd())
+  {
+    long long n, m, u, v;
+    Weight w;
+    switch (in.lineType())
+    {
+    case 'p':
+      in.skipWord();
+      if (in.readInteger(n) && in.readInteger(m))
+      {
+        onHeader(n, m);
+      }
+      break;
+    case 'a':
+      if (in.readInteger(u) && in.readInteger(v) && in.readWeight(w))
+      {
+        onArc(u, v, w);
+      }
+      break;
+    default:
+      break;
+    }
+    in.nextLine();
+  }
+}
+
+static void parseChunk(const char *fileBegin, const char *fileEnd, const char *begin, const char *end, ChunkEdges &chunk)
+{
+  /* a rough guess from the length of a typical arc line */
+  chunk.edges.reserve((end - begin) / 16);
+  scanChunk(fileBegin, fileEnd, begin, end,
+      [&chunk](long long n, long long m) {
+        chunk.numVert = n;
+        chunk.numEdges = m;
+      },
+      [&chunk](long long u, long long v, Weight w) {
+        chunk.edges.push_back(EdgeInfo(u - 1, v - 1, w));
+        chunk.maxVertex = std::max(chunk.maxVertex, std::max(u, v) - 1);
+      });
+}
+
+Graph *readGrFileMapped(std::string filepath, int numThreads, RepeatedEdges repeated)
+{
+  GraphBuilder pg;
+  if (!readGrFileMapped(filepath, pg, numThreads, repeated))
+  {
+    return nullptr;
+  }
+  return new Graph(std::move(pg), numThreads);
+}
+
+/*
+ * Same result as readGrFile. Malformed lines are skipped.
+ *
+ * The file is split into one chunk per thread, each parsed into its own
+ * buffer; the buffers are appended in file order, so the builder gets the
+ * arcs in the same order whatever the number of threads.
+ */
+bool readGrFileMapped(std::string filepath, GraphBuilder &pg, int numThreads, RepeatedEdges repeated)
+{
+  MappedFile file;
+  if (numThreads <= 0)
+  {
+    numThreads = defaultNumThreads();
+  }
+  if (!file.open(filepath, numThreads == 1))
+  {
+    std::cout << "it's closed" << std::endl;
+    return false;
   }
+  if (file.size() < kParallelParseMinBytes)
+  {
+    numThreads = 1;
+  }
+
+  const char *data = file.data();
+  std::vector<ChunkEdges> chunks(numThreads);
+  parallelFor(numThreads, 0, file.size(), [&](long long begin, long long end, int t) {
+    parseChunk(data, data + file.size(), data + begin, data + end, chunks[t]);
+  });
+
+  EdgeIdx numEdges = 0;
+  long long numVert = -1;
+  for (auto it = chunks.begin(); it != chunks.end(); ++it)
+  {
+    numEdges += it->edges.size();
+    if (it->numVert >= 0)
+    {
+      numVert = it->numVert;
+    }
+  }
+  long long maxVertex = -1;
+  for (auto it = chunks.begin(); it != chunks.end(); ++it)
+  {
+    maxVertex = std::max(maxVertex, it->maxVertex);
+  }
+  if (numVert > std::numeric_limits<int>::max() || maxVertex >= std::numeric_limits<int>::max())
+  {
+    std::cerr << filepath << " has more than " << std::numeric_limits<int>::max() << " vertices" << std::endl;
+    return false;
+  }
+  if (numVert >= 0)
+  {
+    pg.setNumVert(numVert);
+  }
+  pg.setNumEdges(numEdges);
+  pg.setRepeatedEdges(repeated);
+  for (auto it = chunks.begin(); it != chunks.end(); ++it)
+  {
+    pg.addEdges(it->edges, it->maxVertex);
+    it->edges = std::vector<EdgeInfo>();
+  }
+  return true;
+}
+
+/* n from the 'p' line, if it comes before the first arc */
+static bool readHeader(const char *begin, const char *end, long long &numVert)
+{
+  Scanner in(begin, end);
+  while (!in.atEnd())
+  {
+    long long m;
+    switch (in.lineType())
+    {
+    case 'p':
+      in.skipWord();
+      return in.readInteger(numVert) && in.readInteger(m) && numVert >= 0;
+    case 'a':
+      return false;
+    default:
+      break;
+    }
+    in.nextLine();
+  }
+  return false;
+}
+
+/*
+ * Each chunk of the file counts the degrees of its own arcs, then places
+ * them from cursors that start where the arcs of the chunks before it end,
+ * so both passes run one chunk per thread without atomics. Repeated arcs
+ * stay in file order, and a stable sort of each adjacency by head is all
+ * RepeatedEdges needs. The cursors take a vertex array per chunk.
+ */
+Graph *readGrFileDirect(std::string filepath, int numThreads, RepeatedEdges repeated)
+{
+  if (numThreads <= 0)
+  {
+    numThreads = defaultNumThreads();
+  }
+  MappedFile file;
+  if (!file.open(filepath, false))
+  {
+    std::cout << "it's closed" << std::endl;
+    return nullptr;
+  }
+  long long numVert;
+  if (!readHeader(file.data(), file.data() + file.size(), numVert))
+  {
+    file.close();
+    return readGrFileMapped(filepath, numThreads, repeated);
+  }
+  if (numVert > std::numeric_limits<int>::max())
+  {
+    std::cerr << filepath << " has " << numVert << " vertices, more than " << std::numeric_limits<int>::max() << std::endl;
+    return nullptr;
+  }
+
+  const char *data = file.data();
+  const char *dataEnd = data + file.size();
+  int chunks = (file.size() < kParallelParseMinBytes ? 1 : numThreads);
+  auto ignoreHeader = [](long long n, long long m) {};
+
+  /* out-degree of v among the arcs of chunk t in cursor[t][v], empty for
+   * chunks parallelFor left without bytes */
+  std::vector<std::vector<EdgeIdx> > cursor(chunks);
+  std::vector<char> outOfRange(chunks, 0);
+  parallelFor(chunks, 0, file.size(), [&](long long begin, long long end, int t) {
+    std::vector<EdgeIdx> &degree = cursor[t];
+    degree.assign(numVert, 0);
+    scanChunk(data, dataEnd, data + begin, data + end, ignoreHeader, [&](long long u, long long v, Weight w) {
+      if (u < 1 || u > numVert || v < 1 || v > numVert)
+      {
+        outOfRange[t] = 1;
+        return;
+      }
+      degree[u - 1]++;
+    });
+  });
+  if (std::find(outOfRange.begin(), outOfRange.end(), 1) != outOfRange.end())
+  {
+    file.close();
+    return readGrFileMapped(filepath, numThreads, repeated);
+  }
+
+  std::shared_ptr<GraphTopology> topology = std::make_shared<GraphTopology>();
+  topology->numVert = numVert;
+  topology->firstEdgeEachV = HugeVector<EdgeIdx>(numVert);
+  HugeVector<EdgeIdx> &firstEdgeEachV = topology->firstEdgeEachV;
+  parallelFor(numThreads, 0, numVert, [&](long long begin, long long end, int t) {
+    for (long long v = begin; v < end; v++)
+    {
+      EdgeIdx degree = 0;
+      for (auto it = cursor.begin(); it != cursor.end(); ++it)
+      {
+        degree += (it->empty() ? 0 : (*it)[v]);
+      }
+      firstEdgeEachV[v] = degree;
+    }
+  });
+  EdgeIdx numEdges = 0;
+  for (long long v = 0; v < numVert; v++)
+  {
+    EdgeIdx degree = firstEdgeEachV[v];
+    firstEdgeEachV[v] = numEdges;
+    numEdges += degree;
+  }
+  /* the arcs of v from chunk t go after those of v from chunks before t */
+  parallelFor(numThreads, 0, numVert, [&](long long begin, long long end, int t) {
+    for (long long v = begin; v < end; v++)
+    {
+      EdgeIdx pos = firstEdgeEachV[v];
+      for (auto it = cursor.begin(); it != cursor.end(); ++it)
+      {
+        if (!it->empty())
+        {
+          EdgeIdx degree = (*it)[v];
+          (*it)[v] = pos;
+          pos += degree;
+        }
+      }
+    }
+  });
+  topology->numEdges = numEdges;
+  topology->heads = HugeVector<int>(numEdges);
+  topology->costs = HugeVector<Weight>(numEdges);
+
+  parallelFor(chunks, 0, file.size(), [&](long long begin, long long end, int t) {
+    std::vector<EdgeIdx> &next = cursor[t];
+    scanChunk(data, dataEnd, data + begin, data + end, ignoreHeader, [&](long long u, long long v, Weight w) {
+      EdgeIdx pos = next[u - 1]++;
+      topology->heads[pos] = v - 1;
+      topology->costs[pos] = w;
+    });
+  });
+  cursor = std::vector<std::vector<EdgeIdx> >();
+  file.close();
+
+  parallelFor(numThreads, 0, numVert, [&](long long begin, long long end, int t) {
+    std::vector<std::pair<int, Weight> > adjacency;
+    for (long long v = begin; v < end; v++)
+    {
+      EdgeIdx first = topology->firstEdgeEachV[v];
+      EdgeIdx endIdx = (v + 1 < numVert ? topology->firstEdgeEachV[v + 1] : numEdges);
+      if (std::is_sorted(topology->heads.begin() + first, topology->heads.begin() + endIdx))
+      {
+        continue;
+      }
+      adjacency.clear();
+      for (EdgeIdx idx = first; idx < endIdx; idx++)
+      {
+        adjacency.push_back(std::make_pair(topology->heads[idx], topology->costs[idx]));
+      }
+      std::stable_sort(adjacency.begin(), adjacency.end(), [](const std::pair<int, Weight> &a, const std::pair<int, Weight> &b) {
+        return a.first < b.first;
+      });
+      for (EdgeIdx idx = first; idx < endIdx; idx++)
+      {
+        topology->heads[idx] = adjacency[idx - first].first;
+        topology->costs[idx] = adjacency[idx - first].second;
+      }
+    }
+  });
+  topology->removeRepeatedEdges(repeated, numThreads);
 
-  return g;
+  return new Graph(std::shared_ptr<const GraphTopology>(topology));
 }
 }
 }
@@ -26,6 +26,28 @@
 
 namespace haruki {
   namespace dimacs {
-    Graph* readGrFile(std::string filepath);
+    /*
+     * Vertices are numbered from 0. Arcs that repeat a (u, v) pair are
+     * left in the builder and sorted out when the Graph is built, see
+     * RepeatedEdges; by default only the first one is kept.
+     */
+    Graph* readGrFile(std::string filepath, RepeatedEdges repeated = KEEP_FIRST_REPEATED);
+    bool readGrFile(std::string filepath, GraphBuilder &pg, RepeatedEdges repeated = KEEP_FIRST_REPEATED);
+    /* drop-in alternative to readGrFile that maps the file and decodes it
+     * in place, several times faster on large graphs. Large files are
+     * parsed in chunks on numThreads threads (0 = one per core) */
+    Graph* readGrFileMapped(std::string filepath, int numThreads = 0, RepeatedEdges repeated = KEEP_FIRST_REPEATED);
+    bool readGrFileMapped(std::string filepath, GraphBuilder &pg, int numThreads = 0, RepeatedEdges repeated = KEEP_FIRST_REPEATED);
+    /*
+     * Same graph as readGrFileMapped, built straight into its CSR arrays
+     * from two passes over the file (degrees, then arcs), so loading takes
+     * little more memory than the graph itself. Needs the 'p' line before
+     * the first arc; files without it, or with arcs out of its range, are
+     * read with readGrFileMapped.
+     */
+    Graph* readGrFileDirect(std::string filepath, int numThreads = 0, RepeatedEdges repeated = KEEP_FIRST_REPEATED);
+
+    /* "all", "first" or "min" */
+    bool parseRepeatedEdges(const std::string &name, RepeatedEdges &repeated);
   }
 }
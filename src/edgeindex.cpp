@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2018 Diogo Haruki Kykuta
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+*/
+#include "edgeindex.hpp"
+
+namespace haruki
+{
+
+EdgeIndex::EdgeIndex(const GraphTopology &topology, double maxLoadFactor)
+{
+  if (!isValidLoadFactor(maxLoadFactor))
+  {
+    maxLoadFactor = 0.5;
+  }
+  int bits = 1;
+  while ((double)(1ull << bits) * maxLoadFactor < topology.numEdges || (1ull << bits) <= (uint64_t)topology.numEdges)
+  {
+    bits++;
+  }
+  shift_ = 64 - bits;
+  Slot empty = {-1, -1, -1};
+  slots_ = std::vector<Slot>(1ull << bits, empty);
+
+  size_t mask = slots_.size() - 1;
+  int prevTail = -1;
+  int prevHead = -1;
+  topology.forEachEdge([&](int tail, EdgeIdx idx, int head) {
+    if (tail == prevTail && head == prevHead)
+    {
+      /* parallel edge, the first one answers the lookups */
+      return;
+    }
+    prevTail = tail;
+    prevHead = head;
+    size_t slot = slotOf(tail, head);
+    while (slots_[slot].edgeIdx != -1)
+    {
+      slot = (slot + 1) & mask;
+    }
+    slots_[slot].tail = tail;
+    slots_[slot].head = head;
+    slots_[slot].edgeIdx = idx;
+  });
+}
+}
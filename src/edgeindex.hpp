@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2018 Diogo Haruki Kykuta
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "graphtopology.hpp"
+
+namespace haruki
+{
+
+/*
+ * Open addressing hash table from (tail, head) to an edge index.
+ *
+ * Each slot keeps the whole key next to the edge index, so a lookup touches
+ * a single cache line of the table and never the topology arrays.
+ * maxLoadFactor trades memory for shorter probe sequences: the table gets at
+ * least numEdges / maxLoadFactor slots of 12 bytes (16 with 64-bit edge
+ * indices), rounded up to a power of two. It has to be in (0, 1), otherwise
+ * 0.5 is used: lookups of missing keys stop at an empty slot, so the table
+ * always keeps more slots than edges.
+ */
+class EdgeIndex
+{
+private:
+  struct Slot
+  {
+    int tail;
+    int head;
+    EdgeIdx edgeIdx;
+  };
+
+  std::vector<Slot> slots_;
+  int shift_;
+
+  size_t slotOf(int tail, int head) const
+  {
+    uint64_t key = ((uint64_t)(uint32_t)tail << 32) | (uint32_t)head;
+    return (size_t)((key * 0x9E3779B97F4A7C15ull) >> shift_);
+  }
+
+public:
+  static bool isValidLoadFactor(double maxLoadFactor) { return maxLoadFactor > 0 && maxLoadFactor < 1; }
+
+  EdgeIndex(const GraphTopology &topology, double maxLoadFactor);
+
+  EdgeIdx find(int tail, int head) const
+  {
+    size_t mask = slots_.size() - 1;
+    for (size_t slot = slotOf(tail, head);; slot = (slot + 1) & mask)
+    {
+      const Slot &s = slots_[slot];
+      if (s.edgeIdx == -1 || (s.tail == tail && s.head == head))
+      {
+        return s.edgeIdx;
+      }
+    }
+  }
+
+  size_t memoryBytes() const { return slots_.size() * sizeof(Slot); }
+};
+}
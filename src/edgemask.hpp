@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2018 Diogo Haruki Kykuta
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include "edgeidx.hpp"
+
+namespace haruki
+{
+
+/*
+ * Removal flags for the edges of a graph, one bit per edge (Graph keeps
+ * its disabled vertices in one as well).
+ *
+ * Bits are grouped in 64-bit words and each word keeps the epoch in which it
+ * was last written. A word whose epoch is not the current one holds the
+ * default flag in all of its bits, so setAll() only bumps the epoch and every
+ * operation costs O(1), no matter how many edges the graph has.
+ * nextEnabled() skips whole words of removed edges at a time.
+ *
+ * A mask may be layered on a base mask (the tombstones of a DeltaOverlay):
+ * flags set in the base read as set here too, whatever setAll() or set()
+ * did, so deleted edges stay deleted across resets.
+ */
+class EdgeMask
+{
+private:
+  std::vector<uint64_t> words_;
+  std::vector<unsigned int> epochs_;
+  unsigned int epoch_;
+  uint64_t defaultWord_;
+  EdgeIdx size_;
+  const EdgeMask *base_;
+
+  uint64_t word(EdgeIdx w) const
+  {
+    uint64_t bits = epochs_[w] == epoch_ ? words_[w] : defaultWord_;
+    return base_ ? bits | base_->word(w) : bits;
+  }
+
+public:
+  EdgeMask() : epoch_(1), defaultWord_(0), size_(0), base_(nullptr) {}
+  EdgeMask(EdgeIdx size, bool flag)
+      : words_((size + 63) / 64, 0), epochs_((size + 63) / 64, 0), epoch_(1),
+        defaultWord_(flag ? ~0ull : 0), size_(size), base_(nullptr) {}
+
+  /* base has to be at least as large as this mask while it is set */
+  void setBase(const EdgeMask *base) { base_ = base; }
+
+  /* new flags read as the default of the last setAll() */
+  void resize(EdgeIdx size)
+  {
+    words_.resize((size + 63) / 64, 0);
+    epochs_.resize((size + 63) / 64, 0);
+    size_ = size;
+  }
+
+  bool get(EdgeIdx idx) const
+  {
+    return (word(idx >> 6) >> (idx & 63)) & 1;
+  }
+
+  void set(EdgeIdx idx, bool flag)
+  {
+    EdgeIdx w = idx >> 6;
+    if (epochs_[w] != epoch_)
+    {
+      words_[w] = defaultWord_;
+      epochs_[w] = epoch_;
+    }
+    uint64_t bit = 1ull << (idx & 63);
+    words_[w] = flag ? (words_[w] | bit) : (words_[w] & ~bit);
+  }
+
+  void setAll(bool flag)
+  {
+    defaultWord_ = flag ? ~0ull : 0;
+    epoch_++;
+    if (epoch_ == ~0u)
+    {
+      /* epoch wrapped around, old stamps could be mistaken for fresh ones */
+      std::fill(epochs_.begin(), epochs_.end(), 0);
+      epoch_ = 1;
+    }
+  }
+
+  /* first index in [idx, endIdx) whose flag is not set, or endIdx */
+  EdgeIdx nextEnabled(EdgeIdx idx, EdgeIdx endIdx) const
+  {
+    if (idx >= endIdx)
+    {
+      return endIdx;
+    }
+    EdgeIdx w = idx >> 6;
+    uint64_t enabled = ~word(w) & (~0ull << (idx & 63));
+    while (enabled == 0)
+    {
+      w++;
+      if ((w << 6) >= endIdx)
+      {
+        return endIdx;
+      }
+      enabled = ~word(w);
+    }
+    return std::min((w << 6) + __builtin_ctzll(enabled), endIdx);
+  }
+
+  /* bits of word w, set for the edges whose flag is not set */
+  uint64_t enabledBits(EdgeIdx w) const { return ~word(w); }
+
+  bool operator[](EdgeIdx idx) const { return get(idx); }
+  EdgeIdx size() const { return size_; }
+};
+}
@@ -47,6 +47,12 @@ namespace haruki
 
 void FengKSP::preproc(Graph &g, int s, int t, int k)
 {
+  /* the yellow graph is built from the CSR arrays, which do not hold the
+   * edges of a delta overlay */
+  if (g.hasDelta())
+  {
+    g.compactDelta();
+  }
   PascoalKSP::preproc(g, s, t, k);
 
   for (int i = 0; i < g.getNumVert(); i++)
@@ -172,54 +178,58 @@ Path FengKSP::generateCandidateAtEdge(Graph &h, int t, std::vector<Path> &R, Pat
 void FengKSP::initializeYellowGraph(Graph &g)
 {
   int numVert = g.getNumVert() + 1;
-  int numEdges = g.getNumEdges() + g.getNumVert();
+  EdgeIdx numEdges = g.getNumEdges() + g.getNumVert();
 
   int artificialEndVertex = g.getNumVert();
 
-  std::vector<EdgeInfo> edgeInfoList;
-  edgeInfoList.reserve(numEdges);
-  std::vector<int> reverseTrace = g.getReverseTrace();
-  std::vector<int> newFirstEdgeEachV = g.getFirstEdgeEachV();
-  newFirstEdgeEachV.reserve(numVert);
-  std::vector<int> newFirstEdgeReverseV = g.getFirstEdgeReverseV();
-  newFirstEdgeReverseV.push_back(g.getNumEdges());
-
+  Span<const EdgeIdx> firstEdgeEachV = g.getFirstEdgeEachV();
+  Span<const int> heads = g.getHeads();
+  Span<const Weight> costs = g.getCosts();
+  Span<const EdgeIdx> firstEdgeReverseV = g.getFirstEdgeReverseV();
+  Span<const EdgeIdx> reverseTrace = g.getReverseTrace();
+  Span<const int> reverseTails = g.getReverseTails();
+
+  std::shared_ptr<GraphTopology> yellow = std::make_shared<GraphTopology>();
+  yellow->numVert = numVert;
+  yellow->numEdges = numEdges;
+  yellow->firstEdgeEachV.reserve(numVert);
+  yellow->heads.reserve(numEdges);
+  yellow->costs.reserve(numEdges);
+  yellow->firstEdgeReverseV.reserve(numVert);
+  yellow->reverseTrace.reserve(numEdges);
+  yellow->reverseTails.reserve(numEdges);
+
+  /* each vertex keeps its edges followed by its artificial edge, so the
+   * original edge idx becomes idx + tail in the yellow graph */
   for (int v = 0; v < g.getNumVert(); v++)
   {
-    newFirstEdgeEachV[v] += v;
-  }
-  newFirstEdgeEachV.push_back(numEdges);
-
-  std::vector<EdgeInfo> allEdges = g.getEdgeInfoList();
-
-  for (unsigned int z = 0; z < reverseTrace.size(); z++) {
-    reverseTrace[z] = reverseTrace[z] + allEdges[reverseTrace[z]].tail;
+    yellow->firstEdgeEachV.push_back(firstEdgeEachV[v] + v);
+    EdgeIdx endIdx = (v + 1 < g.getNumVert() ? firstEdgeEachV[v + 1] : g.getNumEdges());
+    for (EdgeIdx idx = firstEdgeEachV[v]; idx < endIdx; idx++)
+    {
+      yellow->heads.push_back(heads[idx]);
+      yellow->costs.push_back(costs[idx]);
+    }
+    yellow->heads.push_back(artificialEndVertex);
+    yellow->costs.push_back(0);
   }
+  yellow->firstEdgeEachV.push_back(numEdges);
 
-  int i = 0;
-  int eIdx = 0;
-  for (std::vector<EdgeInfo>::iterator it = allEdges.begin(); it != allEdges.end(); ++it)
+  yellow->firstEdgeReverseV.assign(firstEdgeReverseV.begin(), firstEdgeReverseV.end());
+  yellow->firstEdgeReverseV.push_back(g.getNumEdges());
+  for (EdgeIdx z = 0; z < g.getNumEdges(); z++)
   {
-    while (i < (*it).tail)
-    {
-      edgeInfoList.push_back(EdgeInfo(i, artificialEndVertex, 0));
-      i++;
-      reverseTrace.push_back(eIdx);
-      eIdx++;
-    }
-    edgeInfoList.push_back(*it);
-    eIdx++;
+    yellow->reverseTrace.push_back(reverseTrace[z] + reverseTails[z]);
+    yellow->reverseTails.push_back(reverseTails[z]);
   }
-  while (i < g.getNumVert())
+  for (int v = 0; v < g.getNumVert(); v++)
   {
-    edgeInfoList.push_back(EdgeInfo(i, artificialEndVertex, 0));
-    i++;
-    reverseTrace.push_back(eIdx);
-    eIdx++;
+    yellow->reverseTrace.push_back(yellow->firstEdgeEachV[v + 1] - 1);
+    yellow->reverseTails.push_back(v);
   }
 
-  yellowGraph_ = new Graph(newFirstEdgeEachV, newFirstEdgeReverseV,
-                           reverseTrace, edgeInfoList, std::vector<bool>(numEdges, true), numVert, numEdges);
+  yellowGraph_ = new Graph(yellow);
+  yellowGraph_->setAllEdgesRemoved();
 }
 
 std::vector<int> FengKSP::initialColor(Graph &g, int t, std::vector<Path> &R, Path &path, int oldDeviationIdx) {
@@ -280,10 +290,15 @@ std::vector<int> FengKSP::updateColor(Graph &g, int t, std::vector<Path> &R, Pat
 }
 
 void FengKSP::updateArtificialEdges(Graph &g, std::vector<int> newYellowList, int oldDeviation, int deviation) {
+  /* the old deviation is red from now on, so none of its edges come back
+   * until the next setAllEdgesRemoved() */
   if (oldDeviation != -1) { 
-    yellowGraph_->removeVertex(oldDeviation);
+    yellowGraph_->isolateVertex(oldDeviation);
   }
-  yellowGraph_->removeVertex(deviation);
+  /* edges into the new deviation from yellow vertices are enabled again
+   * below and the others have a red end or were never enabled, so only the
+   * edges out of it, those of the shared prefixes among them, are dropped */
+  yellowGraph_->setRemovedForOutgoingEdges(deviation, EDGE_DISABLED);
   // int artificialEndVertex = g.getNumVert();
   for (auto it = newYellowList.begin(); it != newYellowList.end(); ++it) {
     EdgeIn::range edIn = g.getEdgesIn(*it);
@@ -295,7 +310,7 @@ void FengKSP::updateArtificialEdges(Graph &g, std::vector<int> newYellowList, in
         // yellowGraph_->setRemovedEdgeFlag(edge.head, artificialEndVertex, EDGE_DISABLED);
         yellowGraph_->fengSetArtificialEdge(edge.head, EDGE_DISABLED);
         // yellowGraph_->setRemovedEdgeFlag(edge.tail, edge.head, EDGE_ENABLED);
-        int idx = it2.getEdgeIdx() + edge.tail;
+        EdgeIdx idx = it2.getEdgeIdx() + edge.tail;
         yellowGraph_->setRemovedEdgeFlag(idx, EDGE_ENABLED);
       }
     }
@@ -303,7 +318,7 @@ void FengKSP::updateArtificialEdges(Graph &g, std::vector<int> newYellowList, in
     for (EdgeOut::iterator it2 = edOut.begin(); it2 != edOut.end(); ++it2)
     {
       EdgeInfo edge = *it2;
-      int edgeIdx = it2.getEdgeIdx() + edge.tail;
+      EdgeIdx edgeIdx = it2.getEdgeIdx() + edge.tail;
       if (colors_[edge.head] == FENG_COLOR_GREEN) {
         /* it is a new express edge */
         // yellowGraph_->setRemovedEdgeFlag(edge.head, artificialEndVertex, EDGE_ENABLED);
@@ -21,142 +21,427 @@
 */
 #include "graph.hpp"
 #include <algorithm>
-#include <numeric>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include "parallel.hpp"
 
 namespace haruki
 {
 
-bool compareEdgeInfo(EdgeInfo a, EdgeInfo b)
+/* below this many edges the CSR is built on the caller's thread only */
+static const EdgeIdx kParallelBuildMinEdges = 1 << 16;
+/* the dirty edge log may always hold this many entries, however small the
+ * graph */
+static const size_t kMinDirtyLogEntries = 1 << 12;
+
+/* a compaction running in the background, and the changes made to the
+ * graph after it took its snapshot */
+struct Graph::Compaction
+{
+  enum Kind { INSERT, DELETE, UPDATE };
+  std::future<std::shared_ptr<const GraphTopology> > result;
+  std::vector<std::pair<Kind, std::vector<EdgeInfo> > > replay;
+};
+
+struct PlacedEdge
 {
-  if (a.tail != b.tail)
+  int head;
+  EdgeIdx order;
+  Weight cost;
+};
+
+bool comparePlacedEdge(const PlacedEdge &a, const PlacedEdge &b)
+{
+  if (a.head != b.head)
   {
-    return a.tail < b.tail;
+    return a.head < b.head;
   }
-  return a.head < b.head;
+  return a.order < b.order;
 }
 
-class reverseEdgeInfoComparator
+/*
+ * Counting sort of the edges by tail, then a sort of each adjacency by
+ * head. Edges are placed by concurrent threads, so each one remembers its
+ * position in the builder to keep parallel edges in input order, which is
+ * also what the builder's RepeatedEdges policy relies on.
+ */
+Graph::Graph(GraphBuilder pg, int numThreads)
 {
-private:
-  std::vector<EdgeInfo> &edgeInfoList_;
+  std::shared_ptr<GraphTopology> topology = std::make_shared<GraphTopology>();
+  numVert_ = pg.getNumVert();
 
-public:
-  reverseEdgeInfoComparator(std::vector<EdgeInfo> &edgeInfoList) : edgeInfoList_{edgeInfoList} {}
-  bool operator()(int a, int b)
+  const std::vector<EdgeInfo> &edges = pg.getEdges();
+  numEdges_ = edges.size();
+  if (numThreads <= 0)
   {
-    if (edgeInfoList_[a].head != edgeInfoList_[b].head)
+    numThreads = defaultNumThreads();
+  }
+  if (numEdges_ < kParallelBuildMinEdges)
+  {
+    numThreads = 1;
+  }
+
+  std::vector<std::atomic<EdgeIdx> > cursor(numVert_ + 1);
+  parallelFor(numThreads, 0, numVert_ + 1, [&](long long begin, long long end, int t) {
+    for (long long v = begin; v < end; v++)
+    {
+      cursor[v].store(0, std::memory_order_relaxed);
+    }
+  });
+  parallelFor(numThreads, 0, numEdges_, [&](long long begin, long long end, int t) {
+    for (long long idx = begin; idx < end; idx++)
     {
-      return edgeInfoList_[a].head < edgeInfoList_[b].head;
+      cursor[edges[idx].tail + 1].fetch_add(1, std::memory_order_relaxed);
     }
-    return edgeInfoList_[a].tail < edgeInfoList_[b].tail;
+  });
+
+  HugeVector<EdgeIdx> &firstEdgeEachV = topology->firstEdgeEachV;
+  firstEdgeEachV = HugeVector<EdgeIdx>(numVert_);
+  EdgeIdx sum = 0;
+  for (int v = 0; v < numVert_; v++)
+  {
+    EdgeIdx degree = cursor[v + 1].load(std::memory_order_relaxed);
+    firstEdgeEachV[v] = sum;
+    cursor[v].store(sum, std::memory_order_relaxed);
+    sum += degree;
   }
-};
 
-Graph::Graph(GraphBuilder pg)
-{
-  numVert_ = pg.getNumVert();
+  std::vector<PlacedEdge> placed(numEdges_);
+  parallelFor(numThreads, 0, numEdges_, [&](long long begin, long long end, int t) {
+    for (long long idx = begin; idx < end; idx++)
+    {
+      const EdgeInfo &ei = edges[idx];
+      EdgeIdx pos = cursor[ei.tail].fetch_add(1, std::memory_order_relaxed);
+      placed[pos].head = ei.head;
+      placed[pos].order = idx;
+      placed[pos].cost = ei.cost;
+    }
+  });
 
-  edgeInfoList_ = pg.getEdgeInfoList();
-  std::sort(edgeInfoList_.begin(), edgeInfoList_.end(), compareEdgeInfo);
+  EdgeIdx numEdges = numEdges_;
+  parallelFor(numThreads, 0, numVert_, [&](long long begin, long long end, int t) {
+    for (long long v = begin; v < end; v++)
+    {
+      EdgeIdx endIdx = (v + 1 < numVert_ ? firstEdgeEachV[v + 1] : numEdges);
+      std::sort(placed.begin() + firstEdgeEachV[v], placed.begin() + endIdx, comparePlacedEdge);
+    }
+  });
 
-  int i = 0;
-  int j = 0;
-  firstEdgeEachV_ = std::vector<int>(numVert_, 0);
-  for (std::vector<EdgeInfo>::iterator it = edgeInfoList_.begin(); it != edgeInfoList_.end(); it++)
-  {
-    EdgeInfo ei = *it;
-    while (i <= ei.tail)
+  topology->heads = HugeVector<int>(numEdges_);
+  topology->costs = HugeVector<Weight>(numEdges_);
+  parallelFor(numThreads, 0, numEdges_, [&](long long begin, long long end, int t) {
+    for (long long idx = begin; idx < end; idx++)
     {
-      firstEdgeEachV_[i++] = j;
+      topology->heads[idx] = placed[idx].head;
+      topology->costs[idx] = placed[idx].cost;
     }
-    j++;
-  }
-  while (i < numVert_)
-  {
-    firstEdgeEachV_[i++] = j;
-  }
-  numEdges_ = j;
+  });
+  placed = std::vector<PlacedEdge>();
 
-  reverseTrace_ = std::vector<int>(numEdges_);
-  std::iota(std::begin(reverseTrace_), std::end(reverseTrace_), 0);
-  std::sort(std::begin(reverseTrace_), std::end(reverseTrace_), reverseEdgeInfoComparator(edgeInfoList_));
+  topology->numVert = numVert_;
+  topology->numEdges = numEdges_;
+  topology->removeRepeatedEdges(pg.getRepeatedEdges(), numThreads);
+  numEdges_ = topology->numEdges;
 
-  i = 0;
-  j = 0;
-  firstEdgeReverseV_ = std::vector<int>(numVert_, 0);
-  for (std::vector<int>::iterator it = std::begin(reverseTrace_); it != std::end(reverseTrace_); ++it)
+  const std::vector<int> &originalIds = pg.getOriginalIds();
+  if (!originalIds.empty())
   {
-    EdgeInfo ei = edgeInfoList_[*it];
-    while (i <= ei.head)
+    topology->originalIds = originalIds;
+    /* a trimmed graph keeps only some of the input vertices */
+    int maxId = *std::max_element(originalIds.begin(), originalIds.end());
+    topology->internalIds = std::vector<int>(maxId + 1, -1);
+    for (int v = 0; v < numVert_; v++)
     {
-      firstEdgeReverseV_[i++] = j;
+      topology->internalIds[originalIds[v]] = v;
     }
-    j++;
-  }
-  while (i < numVert_)
-  {
-    firstEdgeReverseV_[i++] = j;
   }
 
-  edgesRemoved_ = std::vector<bool>(numEdges_, false);
-  // resetEdgesRemoved();
+  topology->shortcuts = pg.getShortcuts();
+  topology_ = topology;
+  edgesRemoved_ = std::make_shared<const EdgeMask>(numEdges_, EDGE_ENABLED);
+}
+
+Graph::Graph(
+    std::vector<EdgeIdx> firstEdgeEachV,
+    std::vector<EdgeIdx> firstEdgeReverseV,
+    std::vector<EdgeIdx> reverseTrace,
+    std::vector<EdgeInfo> edgeInfoList,
+    EdgeMask edgesRemoved,
+    int numVert,
+    EdgeIdx numEdges
+): edgesRemoved_{std::make_shared<const EdgeMask>(edgesRemoved)},
+numVert_{numVert},
+numEdges_{numEdges}
+{
+  std::shared_ptr<GraphTopology> topology = std::make_shared<GraphTopology>();
+  topology->firstEdgeEachV.assign(firstEdgeEachV.begin(), firstEdgeEachV.end());
+  topology->firstEdgeReverseV.assign(firstEdgeReverseV.begin(), firstEdgeReverseV.end());
+  topology->reverseTrace.assign(reverseTrace.begin(), reverseTrace.end());
+  topology->numVert = numVert;
+  topology->numEdges = numEdges;
+  setEdgeArrays(*topology, edgeInfoList);
+  topology_ = topology;
+}
+
+Graph::Graph(std::shared_ptr<const GraphTopology> topology)
+: topology_{topology},
+edgesRemoved_{std::make_shared<const EdgeMask>(topology->numEdges, EDGE_ENABLED)},
+numVert_{topology->numVert},
+numEdges_{topology->numEdges}
+{
 }
 
 Graph::Graph(Graph &g)
 {
-  firstEdgeEachV_ = g.firstEdgeEachV_;
-  firstEdgeReverseV_ = g.firstEdgeReverseV_;
-  reverseTrace_ = g.reverseTrace_;
-  edgeInfoList_ = g.edgeInfoList_;
+  /* the topology and the overlay are shared, see unshare() */
+  topology_ = g.topology_;
+  costs_ = g.costs_;
   edgesRemoved_ = g.edgesRemoved_;
+  verticesDisabled_ = g.verticesDisabled_;
+  anyVertexDisabled_ = g.anyVertexDisabled_;
+  verticesIsolated_ = g.verticesIsolated_;
+  anyVertexIsolated_ = g.anyVertexIsolated_;
+  edgeIndex_ = g.edgeIndex_;
   numVert_ = g.numVert_;
   numEdges_ = g.numEdges_;
+  costVersion_ = g.costVersion_;
+  dirtyLogStart_ = g.dirtyLogStart_;
+  dirtyLog_ = g.dirtyLog_;
+  delta_ = g.delta_;
+}
+
+/* splits a list already sorted by (tail, head) into heads and costs, and
+ * fills reverseTails in the order given by reverseTrace, if there is one */
+void Graph::setEdgeArrays(GraphTopology &topology, const std::vector<EdgeInfo> &edgeInfoList)
+{
+  topology.heads = HugeVector<int>(edgeInfoList.size());
+  topology.costs = HugeVector<Weight>(edgeInfoList.size());
+  for (size_t idx = 0; idx < edgeInfoList.size(); idx++)
+  {
+    topology.heads[idx] = edgeInfoList[idx].head;
+    topology.costs[idx] = edgeInfoList[idx].cost;
+  }
+
+  if (topology.reverseTrace.empty())
+  {
+    return;
+  }
+  topology.reverseTails = HugeVector<int>(topology.reverseTrace.size());
+  for (size_t idx = 0; idx < topology.reverseTrace.size(); idx++)
+  {
+    topology.reverseTails[idx] = edgeInfoList[topology.reverseTrace[idx]].tail;
+  }
 }
 
 const std::vector<EdgeInfo> Graph::getEdgesByTail(int tail) const
 {
   std::vector<EdgeInfo> edges;
-  int endIdx = (tail + 1 < numVert_ ? firstEdgeEachV_[tail + 1] : numEdges_);
-  for (int idx = firstEdgeEachV_[tail]; idx < endIdx; idx++)
+  EdgeOut::range out = edgesOut(tail);
+  for (auto it = out.begin(); it != out.end(); ++it)
   {
-    if (!edgesRemoved_[idx])
-    {
-      edges.push_back(edgeInfoList_[idx]);
-    }
+    edges.push_back(*it);
   }
 
   return edges;
 }
 
+EdgeOut::range Graph::edgesOut(int v) const
+{
+  /* decode on the fly unless something already needed the plain arrays */
+  const CompressedAdjacency *compressed = nullptr;
+  if ((EdgeIdx)topology_->heads.size() != baseEdges())
+  {
+    compressed = topology_->compressed.get();
+  }
+  return EdgeOut::range(topology_->firstEdgeEachV, topology_->heads, costs(), *edgesRemoved_, numVert_, numEdges_, v, compressed, delta_.get(), disabledVertices(), isolatedVertices());
+}
+
 EdgeOut::range Graph::getEdgesOut(int v)
 {
-  return EdgeOut::range(edgeInfoList_, firstEdgeEachV_, edgesRemoved_, numVert_, numEdges_, v);
+  return edgesOut(v);
 }
 
 EdgeIn::range Graph::getEdgesIn(int v)
 {
-  return EdgeIn::range(edgeInfoList_, firstEdgeReverseV_, reverseTrace_, edgesRemoved_, numVert_, numEdges_, v);
+  if (topology_->symmetric)
+  {
+    topology_->decompress();
+    return EdgeIn::range(topology_->firstEdgeEachV, topology_->reverseTrace, topology_->heads, costs(), *edgesRemoved_, numVert_, numEdges_, v, delta_.get(), disabledVertices(), true, isolatedVertices());
+  }
+  topology_->buildReverse();
+  topology_->decompress();
+  return EdgeIn::range(topology_->firstEdgeReverseV, topology_->reverseTrace, topology_->reverseTails, costs(), *edgesRemoved_, numVert_, numEdges_, v, delta_.get(), disabledVertices(), false, isolatedVertices());
 }
 
 EdgeList::range Graph::getAllEdges()
 {
-  return EdgeList::range(edgeInfoList_, edgesRemoved_);
+  topology_->decompress();
+  return EdgeList::range(topology_->firstEdgeEachV, topology_->heads, costs(), *edgesRemoved_, numVert_, numEdges_, delta_.get(), disabledVertices(), isolatedVertices());
+}
+
+/* edges in index order, those deleted through the delta overlay left out */
+std::vector<EdgeInfo> Graph::getEdgeInfoList() const
+{
+  std::vector<EdgeInfo> edgeInfoList;
+  edgeInfoList.reserve(numEdges_);
+  const DeltaOverlay *delta = delta_.get();
+  topology_->forEachEdge([this, delta, &edgeInfoList](int tail, EdgeIdx idx, int head) {
+    if (!delta || !delta->tombstones[idx])
+    {
+      edgeInfoList.push_back(EdgeInfo(tail, head, costAt(idx)));
+    }
+  });
+  if (delta)
+  {
+    for (EdgeIdx i = 0; i < delta->numInserted(); i++)
+    {
+      if (!delta->tombstones[delta->baseEdges + i])
+      {
+        edgeInfoList.push_back(EdgeInfo(delta->tails[i], delta->heads[i], costAt(delta->baseEdges + i)));
+      }
+    }
+  }
+  return edgeInfoList;
+}
+
+/*
+ * Replaces the topology by one that keeps the forward adjacency compressed,
+ * see CompressedAdjacency. Graphs already sharing the old topology keep it,
+ * so this should be called before the graph is copied.
+ */
+void Graph::compress()
+{
+  if (topology_->compressed)
+  {
+    return;
+  }
+
+  std::shared_ptr<GraphTopology> topology = std::make_shared<GraphTopology>();
+  topology->firstEdgeEachV = topology_->firstEdgeEachV;
+  topology->compressed.reset(new CompressedAdjacency(topology_->firstEdgeEachV, topology_->heads, topology_->costs, numVert_, baseEdges()));
+  if (!topology->compressed->hasCostCodes())
+  {
+    topology->costs = topology_->costs;
+  }
+  topology->firstEdgeReverseV = topology_->firstEdgeReverseV;
+  topology->reverseTrace = topology_->reverseTrace;
+  topology->reverseTails = topology_->reverseTails;
+  topology->originalIds = topology_->originalIds;
+  topology->internalIds = topology_->internalIds;
+  topology->shortcuts = topology_->shortcuts;
+  topology->symmetric = topology_->symmetric;
+  topology->numVert = numVert_;
+  topology->numEdges = topology_->numEdges;
+  topology_ = topology;
+}
+
+/*
+ * Switches to symmetric storage when each edge of the topology has a twin
+ * going the other way and no two edges join the same ends in the same
+ * direction, as in road graphs listing both directions of every street.
+ * The edges into v are then found from the edges out of v, with a binary
+ * search in the adjacency of each tail for the edge index. That index
+ * gives the edge's own cost and removal flag, so the two directions may
+ * cost differently and are removed separately. The reverse index is
+ * dropped; it is built again only for code that asks for its arrays, such
+ * as the yellow graph of Feng and Hybrid.
+ *
+ * Returns whether the storage is symmetric. A compressed graph is left as
+ * it is. Like compress(), this should be called before the graph is copied.
+ */
+bool Graph::useSymmetricStorage()
+{
+  if (topology_->symmetric)
+  {
+    return true;
+  }
+  if (isCompressed())
+  {
+    return false;
+  }
+  const HugeVector<EdgeIdx> &firstEdgeEachV = topology_->firstEdgeEachV;
+  const HugeVector<int> &heads = topology_->heads;
+  for (int v = 0; v < numVert_; v++)
+  {
+    EdgeIdx endIdx = (v + 1 < numVert_ ? firstEdgeEachV[v + 1] : baseEdges());
+    for (EdgeIdx idx = firstEdgeEachV[v]; idx < endIdx; idx++)
+    {
+      if ((idx > firstEdgeEachV[v] && heads[idx] == heads[idx - 1]) || findTopologyEdge(heads[idx], v) == -1)
+      {
+        return false;
+      }
+    }
+  }
+
+  std::shared_ptr<GraphTopology> topology = std::make_shared<GraphTopology>();
+  topology->firstEdgeEachV = topology_->firstEdgeEachV;
+  topology->heads = topology_->heads;
+  topology->costs = topology_->costs;
+  topology->originalIds = topology_->originalIds;
+  topology->internalIds = topology_->internalIds;
+  topology->shortcuts = topology_->shortcuts;
+  topology->symmetric = true;
+  topology->numVert = numVert_;
+  topology->numEdges = topology_->numEdges;
+  topology_ = topology;
+  return true;
+}
+
+size_t Graph::topologyBytes() const
+{
+  const GraphTopology &t = *topology_;
+  size_t bytes = (t.firstEdgeEachV.capacity() + t.firstEdgeReverseV.capacity() + t.reverseTrace.capacity()) * sizeof(EdgeIdx)
+      + (t.heads.capacity() + t.reverseTails.capacity()) * sizeof(int)
+      + t.costs.capacity() * sizeof(Weight);
+  if (t.compressed)
+  {
+    bytes += t.compressed->memoryBytes();
+  }
+  return bytes;
 }
 
-const int Graph::getEdgeIndex(int tail, int head) const
+void Graph::buildEdgeIndex(double maxLoadFactor)
 {
-  int startIdx = firstEdgeEachV_[tail];
-  int endIdx = (tail + 1 < numVert_ ? firstEdgeEachV_[tail + 1] : numEdges_);
+  edgeIndex_ = std::make_shared<const EdgeIndex>(*topology_, maxLoadFactor);
+}
 
-  int middle;
+/* edges deleted through the delta overlay are not found */
+const EdgeIdx Graph::getEdgeIndex(int tail, int head) const
+{
+  EdgeIdx edgeIdx = findTopologyEdge(tail, head);
+  if (!delta_ || (edgeIdx != -1 && !delta_->tombstones[edgeIdx]))
+  {
+    return edgeIdx;
+  }
+  return delta_->find(tail, head);
+}
+
+EdgeIdx Graph::findTopologyEdge(int tail, int head) const
+{
+  if (edgeIndex_)
+  {
+    return edgeIndex_->find(tail, head);
+  }
+
+  const HugeVector<EdgeIdx> &firstEdgeEachV = topology_->firstEdgeEachV;
+  const HugeVector<int> &heads = topology_->heads;
+  EdgeIdx startIdx = firstEdgeEachV[tail];
+  EdgeIdx endIdx = (tail + 1 < numVert_ ? firstEdgeEachV[tail + 1] : baseEdges());
+  if ((EdgeIdx)heads.size() != baseEdges())
+  {
+    return topology_->compressed->find(tail, head, startIdx, endIdx);
+  }
+
+  EdgeIdx middle;
   while (startIdx < endIdx)
   {
     middle = (endIdx + startIdx) / 2;
-    if (edgeInfoList_[middle].head == head)
+    if (heads[middle] == head)
     {
       return middle;
     }
-    else if (edgeInfoList_[middle].head < head)
+    else if (heads[middle] < head)
     {
       startIdx = middle + 1;
     }
@@ -168,16 +453,389 @@ const int Graph::getEdgeIndex(int tail, int head) const
   return -1;
 }
 
-const double Graph::getEdgeCost(int tail, int head) const
+const Weight Graph::getEdgeCost(int tail, int head) const
 {
-  int edgeIdx = getEdgeIndex(tail, head);
-  if (edgeIdx != -1 && !edgesRemoved_[edgeIdx])
+  EdgeIdx edgeIdx = getEdgeIndex(tail, head);
+  if (edgeIdx != -1 && !(*edgesRemoved_)[edgeIdx] && !isVertexDisabled(tail) && !isVertexIsolated(head))
   {
-    return edgeInfoList_[edgeIdx].cost;
+    return costAt(edgeIdx);
   }
   return -1.0;
 }
 
+Weight Graph::costAt(EdgeIdx edgeIdx) const
+{
+  const HugeVector<Weight> &c = costs();
+  if (edgeIdx < (EdgeIdx)c.size())
+  {
+    return c[edgeIdx];
+  }
+  if (edgeIdx >= baseEdges())
+  {
+    return delta_->costs[edgeIdx - baseEdges()];
+  }
+  return topology_->compressed->cost(edgeIdx);
+}
+
+/* the cost array of this graph alone, taken from the topology (and the
+ * overlay) the first time */
+HugeVector<Weight> &Graph::mutableCosts()
+{
+  if (!costs_)
+  {
+    std::shared_ptr<HugeVector<Weight> > costs = std::make_shared<HugeVector<Weight> >();
+    if ((EdgeIdx)topology_->costs.size() != baseEdges())
+    {
+      topology_->compressed->decodeCosts(baseEdges(), *costs);
+    }
+    else
+    {
+      *costs = topology_->costs;
+    }
+    if (delta_)
+    {
+      costs->insert(costs->end(), delta_->costs.begin(), delta_->costs.end());
+    }
+    costs_ = costs;
+    return *costs;
+  }
+  return unshare(costs_);
+}
+
+void Graph::setEdgeCost(EdgeIdx edgeIdx, Weight cost)
+{
+  mutableCosts()[edgeIdx] = cost;
+}
+
+/*
+ * Sets the cost of the edges (tail, head) listed in updates, the first one
+ * of parallel edges, and returns how many of them exist. Costs are written
+ * in place when no other graph shares the topology, otherwise it is copied
+ * first so that the others (a KSP run on a copy, for instance) keep the
+ * costs they started with; so is a topology that views a snapshot file. A graph with rewritten costs (see setEdgeCost)
+ * gets the update on its own copy of the costs.
+ *
+ * Each call is one batch: it bumps the cost version and logs the edges it
+ * changed, see getDirtyEdges().
+ */
+EdgeIdx Graph::updateEdgeCosts(const std::vector<EdgeInfo> &updates)
+{
+  if (compaction_)
+  {
+    compaction_->replay.push_back(std::make_pair(Compaction::UPDATE, updates));
+  }
+  HugeVector<Weight> *target = costs_ ? &mutableCosts() : nullptr;
+  if (!costs_)
+  {
+    if (topology_.use_count() > 1 || topology_->mapping)
+    {
+      topology_ = topology_->clone();
+    }
+    GraphTopology &topology = *std::const_pointer_cast<GraphTopology>(topology_);
+    if ((EdgeIdx)topology.costs.size() != baseEdges())
+    {
+      topology.compressed->decodeCosts(baseEdges(), topology.costs);
+    }
+    target = &topology.costs;
+  }
+
+  costVersion_++;
+  if (!dirtyLog_)
+  {
+    dirtyLog_ = std::make_shared<const DirtyLog>();
+  }
+  DirtyLog &log = unshare(dirtyLog_);
+  log.batches.push_back(std::make_pair(costVersion_, log.edges.size()));
+  EdgeIdx applied = 0;
+  for (auto it = updates.begin(); it != updates.end(); ++it)
+  {
+    EdgeIdx edgeIdx = getEdgeIndex(it->tail, it->head);
+    if (edgeIdx == -1)
+    {
+      continue;
+    }
+    if (!costs_ && edgeIdx >= baseEdges())
+    {
+      mutableDelta().costs[edgeIdx - baseEdges()] = it->cost;
+    }
+    else
+    {
+      (*target)[edgeIdx] = it->cost;
+    }
+    log.edges.push_back(edgeIdx);
+    applied++;
+  }
+  trimDirtyLog();
+  return applied;
+}
+
+/*
+ * Once the log holds more entries than the graph has edges, replaying it
+ * costs more than treating every edge as changed: the oldest batches are
+ * dropped until at most half of that is left, and getDirtyEdges() answers
+ * false for the versions before them.
+ */
+void Graph::trimDirtyLog()
+{
+  size_t limit = std::max((size_t)numEdges_, kMinDirtyLogEntries);
+  if (dirtyLog_->edges.size() <= limit)
+  {
+    return;
+  }
+  DirtyLog &log = unshare(dirtyLog_);
+  size_t kept = 0;
+  while (kept < log.batches.size() && log.edges.size() - log.batches[kept].second > limit / 2)
+  {
+    kept++;
+  }
+  if (kept == log.batches.size())
+  {
+    clearDirtyEdges();
+    return;
+  }
+  dirtyLogStart_ = log.batches[kept - 1].first;
+  size_t dropped = log.batches[kept].second;
+  log.edges.erase(log.edges.begin(), log.edges.begin() + dropped);
+  log.batches.erase(log.batches.begin(), log.batches.begin() + kept);
+  for (auto it = log.batches.begin(); it != log.batches.end(); ++it)
+  {
+    it->second -= dropped;
+  }
+}
+
+/*
+ * Edges whose cost changed in the batches after sinceVersion, sorted and
+ * without repetitions. Returns false, and no edges, if those batches were
+ * dropped by clearDirtyEdges() or trimmed from a long log: the caller has
+ * to assume all edges changed.
+ */
+bool Graph::getDirtyEdges(uint64_t sinceVersion, std::vector<EdgeIdx> &edges) const
+{
+  edges.clear();
+  if (sinceVersion < dirtyLogStart_)
+  {
+    return false;
+  }
+  if (!dirtyLog_)
+  {
+    return true;
+  }
+  const DirtyLog &log = *dirtyLog_;
+  for (auto it = log.batches.begin(); it != log.batches.end(); ++it)
+  {
+    if (it->first > sinceVersion)
+    {
+      edges.assign(log.edges.begin() + it->second, log.edges.end());
+      break;
+    }
+  }
+  std::sort(edges.begin(), edges.end());
+  edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+  return true;
+}
+
+void Graph::clearDirtyEdges()
+{
+  dirtyLog_.reset();
+  dirtyLogStart_ = costVersion_;
+}
+
+DeltaOverlay &Graph::mutableDelta()
+{
+  if (!delta_)
+  {
+    delta_ = std::make_shared<const DeltaOverlay>(numVert_, baseEdges());
+  }
+  DeltaOverlay &delta = unshare(delta_);
+  mutableRemoved().setBase(&delta.tombstones);
+  return delta;
+}
+
+/*
+ * Adds the given edges without rebuilding the CSR: they get the indices
+ * after the current last edge and are seen by every iterator and lookup of
+ * this graph, not by copies made before. Edges with an endpoint outside
+ * the graph are skipped; returns how many were inserted.
+ */
+EdgeIdx Graph::insertEdges(const std::vector<EdgeInfo> &edges)
+{
+  if (compaction_)
+  {
+    compaction_->replay.push_back(std::make_pair(Compaction::INSERT, edges));
+  }
+  DeltaOverlay &delta = mutableDelta();
+  HugeVector<Weight> *costs = costs_ ? &mutableCosts() : nullptr;
+  EdgeIdx inserted = 0;
+  for (auto it = edges.begin(); it != edges.end(); ++it)
+  {
+    if (it->tail < 0 || it->tail >= numVert_ || it->head < 0 || it->head >= numVert_)
+    {
+      continue;
+    }
+    delta.insert(*it);
+    if (costs)
+    {
+      costs->push_back(it->cost);
+    }
+    inserted++;
+  }
+  numEdges_ = delta.baseEdges + delta.numInserted();
+  mutableRemoved().resize(numEdges_);
+  maybeStartCompaction();
+  return inserted;
+}
+
+/*
+ * Deletes the edges (tail, head) listed, the first one of parallel edges,
+ * by leaving a tombstone: their indices stay valid but they are removed
+ * for good, resetEdgesRemoved() does not bring them back. Returns how many
+ * existed.
+ */
+EdgeIdx Graph::deleteEdges(const std::vector<EdgeInfo> &edges)
+{
+  if (compaction_)
+  {
+    compaction_->replay.push_back(std::make_pair(Compaction::DELETE, edges));
+  }
+  EdgeIdx deleted = 0;
+  for (auto it = edges.begin(); it != edges.end(); ++it)
+  {
+    EdgeIdx edgeIdx = getEdgeIndex(it->tail, it->head);
+    if (edgeIdx != -1)
+    {
+      mutableDelta().erase(edgeIdx);
+      deleted++;
+    }
+  }
+  maybeStartCompaction();
+  return deleted;
+}
+
+/* the edges of g left after its overlay, with the costs g sees, in a new CSR */
+static std::shared_ptr<const GraphTopology> compactTopology(const Graph &g, int numThreads)
+{
+  GraphBuilder pg;
+  pg.setNumVert(g.getNumVert());
+  std::vector<EdgeInfo> edges = g.getEdgeInfoList();
+  pg.setNumEdges(edges.size());
+  for (auto it = edges.begin(); it != edges.end(); ++it)
+  {
+    pg.addEdge(*it);
+  }
+  edges = std::vector<EdgeInfo>();
+  pg.setOriginalIds(g.getOriginalIds());
+  pg.setShortcuts(g.getShortcuts());
+
+  Graph compacted(std::move(pg), numThreads);
+  if (g.isSymmetric())
+  {
+    compacted.useSymmetricStorage();
+  }
+  if (g.isCompressed())
+  {
+    compacted.compress();
+  }
+  return compacted.getTopology();
+}
+
+/* edge indices change: removal flags and rewritten costs are dropped, and
+ * so is the dirty edge log, as if every cost had changed */
+void Graph::installCompacted(std::shared_ptr<const GraphTopology> topology)
+{
+  topology_ = topology;
+  delta_.reset();
+  costs_.reset();
+  numEdges_ = topology->numEdges;
+  edgesRemoved_ = std::make_shared<const EdgeMask>(numEdges_, EDGE_ENABLED);
+  if (edgeIndex_)
+  {
+    buildEdgeIndex();
+  }
+  costVersion_++;
+  clearDirtyEdges();
+}
+
+/*
+ * Folds the delta overlay into a fresh CSR on the caller's thread, after
+ * waiting for a compaction running in the background, if any.
+ */
+void Graph::compactDelta(int numThreads)
+{
+  waitCompaction();
+  if (delta_)
+  {
+    installCompacted(compactTopology(*this, numThreads));
+  }
+}
+
+/*
+ * Once the overlay holds more than fraction times the edges of the CSR,
+ * insertEdges() and deleteEdges() start a compaction on a snapshot of the
+ * graph in a background thread, 0 turns it off. The graph keeps working on
+ * the overlay meanwhile; the compacted topology is installed by the first
+ * of these calls to see it done (or by pollCompaction()), which then
+ * replays the changes made after the snapshot.
+ */
+void Graph::setCompactionThreshold(double fraction, int numThreads)
+{
+  compactionThreshold_ = fraction;
+  compactionThreads_ = numThreads;
+  maybeStartCompaction();
+}
+
+void Graph::maybeStartCompaction()
+{
+  pollCompaction();
+  if (compaction_ || compactionThreshold_ <= 0 || getDeltaSize() <= compactionThreshold_ * baseEdges())
+  {
+    return;
+  }
+  std::shared_ptr<Graph> snapshot = std::make_shared<Graph>(*this);
+  int numThreads = compactionThreads_;
+  compaction_ = std::make_shared<Compaction>();
+  compaction_->result = std::async(std::launch::async, [snapshot, numThreads]() {
+    return compactTopology(*snapshot, numThreads);
+  });
+}
+
+/* installs a finished background compaction, returns whether there was one */
+bool Graph::pollCompaction()
+{
+  if (!compaction_ || compaction_->result.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+  {
+    return false;
+  }
+  std::shared_ptr<Compaction> compaction = compaction_;
+  compaction_.reset();
+  installCompacted(compaction->result.get());
+  for (auto it = compaction->replay.begin(); it != compaction->replay.end(); ++it)
+  {
+    switch (it->first)
+    {
+    case Compaction::INSERT:
+      insertEdges(it->second);
+      break;
+    case Compaction::DELETE:
+      deleteEdges(it->second);
+      break;
+    case Compaction::UPDATE:
+      updateEdgeCosts(it->second);
+      break;
+    }
+  }
+  return true;
+}
+
+/* replaying may start another compaction, which is waited for as well */
+void Graph::waitCompaction()
+{
+  while (compaction_)
+  {
+    compaction_->result.wait();
+    pollCompaction();
+  }
+}
+
 void Graph::removeEdge(int tail, int head)
 {
   setRemovedEdgeFlag(tail, head, true);
@@ -185,16 +843,16 @@ void Graph::removeEdge(int tail, int head)
 
 void Graph::setRemovedEdgeFlag(int tail, int head, bool flag)
 {
-  int edgeIdx = getEdgeIndex(tail, head);
+  EdgeIdx edgeIdx = getEdgeIndex(tail, head);
   if (edgeIdx != -1)
   {
-    edgesRemoved_[edgeIdx] = flag;
+    mutableRemoved().set(edgeIdx, flag);
   }
 }
 
-void Graph::setRemovedEdgeFlag(int edgeIndex, bool flag)
+void Graph::setRemovedEdgeFlag(EdgeIdx edgeIndex, bool flag)
 {
-  edgesRemoved_[edgeIndex] = flag;
+  mutableRemoved().set(edgeIndex, flag);
 }
 
 void Graph::removeEdges(std::vector<EdgeInfo> edges)
@@ -205,17 +863,53 @@ void Graph::removeEdges(std::vector<EdgeInfo> edges)
   }
 }
 
-const bool Graph::isRemoved(int edgeIdx) const
+/* the ends of the edge are only looked up while some vertex is disabled */
+const bool Graph::isRemoved(EdgeIdx edgeIdx) const
 {
-  return edgesRemoved_[edgeIdx];
+  if ((*edgesRemoved_)[edgeIdx])
+  {
+    return true;
+  }
+  if (anyVertexDisabled_)
+  {
+    int tail;
+    if (edgeIdx < baseEdges())
+    {
+      const HugeVector<EdgeIdx> &firstEdgeEachV = topology_->firstEdgeEachV;
+      tail = std::upper_bound(firstEdgeEachV.begin(), firstEdgeEachV.end(), edgeIdx) - firstEdgeEachV.begin() - 1;
+    }
+    else
+    {
+      tail = delta_->tails[edgeIdx - baseEdges()];
+    }
+    if ((*verticesDisabled_)[tail])
+    {
+      return true;
+    }
+  }
+  if (anyVertexIsolated_)
+  {
+    int head;
+    if (edgeIdx < baseEdges())
+    {
+      topology_->decompress();
+      head = topology_->heads[edgeIdx];
+    }
+    else
+    {
+      head = delta_->heads[edgeIdx - baseEdges()];
+    }
+    return (*verticesIsolated_)[head];
+  }
+  return false;
 }
  
 const bool Graph::isRemoved(int tail, int head) const
 {
-  int edgeIdx = getEdgeIndex(tail, head);
+  EdgeIdx edgeIdx = getEdgeIndex(tail, head);
   if (edgeIdx != -1)
   {
-    return isRemoved(edgeIdx);
+    return (*edgesRemoved_)[edgeIdx] || isVertexDisabled(tail) || isVertexIsolated(head);
   }
 
   return true;
@@ -233,23 +927,65 @@ void Graph::resetEdgesRemoved()
 
 void Graph::setAllEdges(bool flag)
 {
-  std::fill(edgesRemoved_.begin(), edgesRemoved_.end(), flag);
+  mutableRemoved().setAll(flag);
+  if (anyVertexDisabled_)
+  {
+    unshare(verticesDisabled_).setAll(false);
+    anyVertexDisabled_ = false;
+  }
+  if (anyVertexIsolated_)
+  {
+    unshare(verticesIsolated_).setAll(false);
+    anyVertexIsolated_ = false;
+  }
 }
 
 void Graph::setRemovedForIncomingEdges(int v, bool flag)
 {
-  int endIdx = (v + 1 < numVert_ ? firstEdgeReverseV_[v + 1] : numEdges_);
-  for (int idx = firstEdgeReverseV_[v]; idx < endIdx; idx++)
+  EdgeMask &removed = mutableRemoved();
+  if (topology_->symmetric)
+  {
+    topology_->decompress();
+    const HugeVector<EdgeIdx> &firstEdgeEachV = topology_->firstEdgeEachV;
+    EdgeIdx endIdx = (v + 1 < numVert_ ? firstEdgeEachV[v + 1] : baseEdges());
+    for (EdgeIdx idx = firstEdgeEachV[v]; idx < endIdx; idx++)
+    {
+      removed.set(findTopologyEdge(topology_->heads[idx], v), flag);
+    }
+  }
+  else
+  {
+    topology_->buildReverse();
+    const HugeVector<EdgeIdx> &firstEdgeReverseV = topology_->firstEdgeReverseV;
+    EdgeIdx endIdx = (v + 1 < numVert_ ? firstEdgeReverseV[v + 1] : baseEdges());
+    for (EdgeIdx idx = firstEdgeReverseV[v]; idx < endIdx; idx++)
+    {
+      removed.set(topology_->reverseTrace[idx], flag);
+    }
+  }
+  if (delta_)
   {
-    edgesRemoved_[reverseTrace_[idx]] = flag;
+    for (auto it = delta_->in[v].begin(); it != delta_->in[v].end(); ++it)
+    {
+      removed.set(*it, flag);
+    }
   }
 }
 
 void Graph::setRemovedForOutgoingEdges(int v, bool flag) {
-  int endIdx = (v + 1 < numVert_ ? firstEdgeEachV_[v + 1] : numEdges_);
-  for (int idx = firstEdgeEachV_[v]; idx < endIdx; idx++)
+  const HugeVector<EdgeIdx> &firstEdgeEachV = topology_->firstEdgeEachV;
+  EdgeMask &removed = mutableRemoved();
+  EdgeIdx endIdx = (v + 1 < numVert_ ? firstEdgeEachV[v + 1] : baseEdges());
+  for (EdgeIdx idx = firstEdgeEachV[v]; idx < endIdx; idx++)
+  {
+    removed.set(idx, flag);
+  }
+  if (delta_)
   {
-    edgesRemoved_[idx] = flag;
+    for (auto it = delta_->out[v].begin(); it != delta_->out[v].end(); ++it)
+    {
+      removed.set(*it, flag);
+    }
   }
 }
 
@@ -258,6 +994,36 @@ void Graph::removeVertex(int v) {
   setRemovedForIncomingEdges(v, EDGE_DISABLED);
 }
 
+/*
+ * Removes every edge out of v in O(1): iterators and lookups skip them
+ * until the next setAllEdges(), while their own flags are left as they
+ * were. Unlike removeVertex(), edges into v are kept, so v can still be
+ * reached, it just leads nowhere.
+ */
+void Graph::disableVertex(int v) {
+  if (!verticesDisabled_)
+  {
+    verticesDisabled_ = std::make_shared<const EdgeMask>(numVert_, false);
+  }
+  unshare(verticesDisabled_).set(v, true);
+  anyVertexDisabled_ = true;
+}
+
+/*
+ * Removes every edge into and out of v in O(1), the same way
+ * disableVertex() does for the edges out of it: the effect of
+ * removeVertex(), without walking the edges of v or touching their flags.
+ */
+void Graph::isolateVertex(int v) {
+  disableVertex(v);
+  if (!verticesIsolated_)
+  {
+    verticesIsolated_ = std::make_shared<const EdgeMask>(numVert_, false);
+  }
+  unshare(verticesIsolated_).set(v, true);
+  anyVertexIsolated_ = true;
+}
+
 void Graph::fengRemoveArtificialEdges(std::vector<int> &vertToRemove)
 {
   // std::sort(vertToRemove.begin(), vertToRemove.end());
@@ -281,9 +1047,9 @@ void Graph::fengAddArtificialEdges(std::vector<int> &newExpressVertex)
 }
 
 void Graph::fengSetArtificialEdge(int fromVertex, bool flag) {
-  int idx = -1;
+  EdgeIdx idx = -1;
   if (fromVertex < numVert_ -1) {
-    idx = firstEdgeEachV_[fromVertex+1] -1;
+    idx = topology_->firstEdgeEachV[fromVertex+1] -1;
   }
   else {
     idx = numEdges_ - 1;
@@ -296,11 +1062,20 @@ void Graph::fengSetArtificialEdge(int fromVertex, bool flag) {
 /*
  * GraphBuilder
  */
-void GraphBuilder::addEdge(int tail, int head, double cost)
+void GraphBuilder::addEdge(int tail, int head, Weight cost)
 {
   addEdge(EdgeInfo(tail, head, cost));
 }
 
+void GraphBuilder::addEdges(const std::vector<EdgeInfo> &edges, int maxVertex)
+{
+  if (maxVertex + 1 > numVert_)
+  {
+    numVert_ = maxVertex + 1;
+  }
+  edgeInfoList_.insert(edgeInfoList_.end(), edges.begin(), edges.end());
+}
+
 void GraphBuilder::addEdge(const EdgeInfo &edgeInfo)
 {
   if (edgeInfo.head + 1 > numVert_)
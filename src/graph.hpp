@@ -22,8 +22,15 @@
 #pragma once
 
 #include <vector>
+#include <memory>
+#include <cstdint>
 #include "graphaux.hpp"
+#include "graphtopology.hpp"
+#include "edgeindex.hpp"
+#include "span.hpp"
 #include "graphiterators.hpp"
+#include "edgemask.hpp"
+#include "deltaoverlay.hpp"
 
 #define EDGE_DISABLED true
 #define EDGE_ENABLED false
@@ -34,46 +41,118 @@ namespace haruki
 class Graph
 {
 private:
-  std::vector<int> firstEdgeEachV_;
-  std::vector<int> firstEdgeReverseV_;
-  std::vector<int> reverseTrace_;
-  std::vector<EdgeInfo> edgeInfoList_;
-  std::vector<bool> edgesRemoved_;
+  std::shared_ptr<const GraphTopology> topology_;
+  /* per-graph overlay on top of the shared topology: costs_ stays null
+   * until some cost is rewritten, then holds the whole cost array. Copies
+   * of a graph share the overlay too, each part is cloned by the first
+   * write to it while shared (see unshare()) */
+  std::shared_ptr<const HugeVector<Weight> > costs_;
+  std::shared_ptr<const EdgeMask> edgesRemoved_;
+  /* a disabled vertex has all of its out-edges removed, without touching
+   * their flags; cleared together with them by setAllEdges() */
+  std::shared_ptr<const EdgeMask> verticesDisabled_;
+  bool anyVertexDisabled_ = false;
+  /* an isolated vertex is disabled and has its in-edges removed as well */
+  std::shared_ptr<const EdgeMask> verticesIsolated_;
+  bool anyVertexIsolated_ = false;
+  /* optional (tail, head) lookup table, binary search is used without it */
+  std::shared_ptr<const EdgeIndex> edgeIndex_;
   int numVert_;
-  int numEdges_;
+  EdgeIdx numEdges_;
+  /* bumped by each updateEdgeCosts() batch; the log holds the edges each
+   * batch changed and (version, first entry in edges) for each batch. It
+   * is shared by copies like the overlay and capped, see trimDirtyLog() */
+  struct DirtyLog
+  {
+    std::vector<EdgeIdx> edges;
+    std::vector<std::pair<uint64_t, size_t> > batches;
+  };
+  uint64_t costVersion_ = 0;
+  uint64_t dirtyLogStart_ = 0;
+  std::shared_ptr<const DirtyLog> dirtyLog_;
+  /* edges inserted and deleted since the topology was built, if any */
+  std::shared_ptr<const DeltaOverlay> delta_;
+  /* a compaction starts in the background once the overlay holds more
+   * than compactionThreshold_ * (edges of the topology) changes */
+  struct Compaction;
+  std::shared_ptr<Compaction> compaction_;
+  double compactionThreshold_ = 0;
+  int compactionThreads_ = 0;
 
-  const int getEdgeIndex(int tail, int head) const;
+  const EdgeIdx getEdgeIndex(int tail, int head) const;
+  EdgeIdx findTopologyEdge(int tail, int head) const;
+  EdgeIdx baseEdges() const { return topology_->numEdges; }
+  DeltaOverlay &mutableDelta();
+  HugeVector<Weight> &mutableCosts();
+  EdgeMask &mutableRemoved() { return unshare(edgesRemoved_); }
+  void maybeStartCompaction();
+  void trimDirtyLog();
+  void installCompacted(std::shared_ptr<const GraphTopology> topology);
+  const HugeVector<Weight> &costs() const { return costs_ ? *costs_ : topology_->costs; }
+  Weight costAt(EdgeIdx edgeIdx) const;
+  EdgeOut::range edgesOut(int v) const;
+  const EdgeMask *disabledVertices() const { return anyVertexDisabled_ ? verticesDisabled_.get() : nullptr; }
+  const EdgeMask *isolatedVertices() const { return anyVertexIsolated_ ? verticesIsolated_.get() : nullptr; }
+
+  /* the object behind p, cloned first if other graphs share it */
+  template <typename T>
+  static T &unshare(std::shared_ptr<const T> &p)
+  {
+    if (p.use_count() > 1)
+    {
+      p = std::make_shared<const T>(*p);
+    }
+    return *std::const_pointer_cast<T>(p);
+  }
+  static void setEdgeArrays(GraphTopology &topology, const std::vector<EdgeInfo> &edgeInfoList);
 
 public:
-  Graph(GraphBuilder pg);
+  Graph(GraphBuilder pg, int numThreads = 0);
   Graph(Graph& g);
+  Graph(std::shared_ptr<const GraphTopology> topology);
   Graph(
-      std::vector<int> firstEdgeEachV,
-      std::vector<int> firstEdgeReverseV,
-      std::vector<int> reverseTrace,
+      std::vector<EdgeIdx> firstEdgeEachV,
+      std::vector<EdgeIdx> firstEdgeReverseV,
+      std::vector<EdgeIdx> reverseTrace,
       std::vector<EdgeInfo> edgeInfoList,
-      std::vector<bool> edgesRemoved,
+      EdgeMask edgesRemoved,
       int numVert,
-      int numEdges
-  ): firstEdgeEachV_{firstEdgeEachV},
-  firstEdgeReverseV_{firstEdgeReverseV},
-  reverseTrace_{reverseTrace},
-  edgeInfoList_{edgeInfoList},
-  edgesRemoved_{edgesRemoved},
-  numVert_{numVert},
-  numEdges_{numEdges}
-  {}
-
+      EdgeIdx numEdges
+  );
 
+  std::shared_ptr<const GraphTopology> getTopology() const { return topology_; }
+  void buildReverseIndex() const { topology_->buildReverse(); }
+  void buildEdgeIndex(double maxLoadFactor = 0.5);
+  void dropEdgeIndex() { edgeIndex_.reset(); }
+  bool hasEdgeIndex() const { return edgeIndex_ != nullptr; }
+  size_t edgeIndexBytes() const { return edgeIndex_ ? edgeIndex_->memoryBytes() : 0; }
+  void compress();
+  bool useSymmetricStorage();
+  bool isSymmetric() const { return topology_->symmetric; }
+  bool isCompressed() const { return topology_->compressed != nullptr; }
+  size_t topologyBytes() const;
+  bool hasOriginalIds() const { return !topology_->originalIds.empty(); }
+  const std::vector<int> &getOriginalIds() const { return topology_->originalIds; }
+  bool hasShortcuts() const { return topology_->shortcuts != nullptr; }
+  std::shared_ptr<const ShortcutTable> getShortcuts() const { return topology_->shortcuts; }
+  int toOriginalId(int v) const { return hasOriginalIds() ? topology_->originalIds[v] : v; }
+  int toInternalId(int v) const
+  {
+    if (!hasOriginalIds())
+    {
+      return v;
+    }
+    return v >= 0 && v < (int)topology_->internalIds.size() ? topology_->internalIds[v] : -1;
+  }
   const std::vector<EdgeInfo> getEdgesByTail(int tail) const;
   EdgeOut::range getEdgesOut(int v);
   EdgeIn::range getEdgesIn(int v);
   EdgeList::range getAllEdges();
   int getNumVert() const { return numVert_; }
-  int getNumEdges() const { return numEdges_; }
+  EdgeIdx getNumEdges() const { return numEdges_; }
   void removeEdge(int tail, int head);
   void setRemovedEdgeFlag(int tail, int head, bool flag);
-  void setRemovedEdgeFlag(int edgeIndex, bool flag);
+  void setRemovedEdgeFlag(EdgeIdx edgeIndex, bool flag);
   void removeEdges(std::vector<EdgeInfo> edges);
   void setAllEdgesRemoved();
   void resetEdgesRemoved();
@@ -81,17 +160,43 @@ public:
   void setRemovedForIncomingEdges(int v, bool flag);
   void setRemovedForOutgoingEdges(int v, bool flag);
   void removeVertex(int v);
-  const double getEdgeCost(int tail, int head) const;
-  const bool isRemoved(int edgeIdx) const;
+  void disableVertex(int v);
+  void isolateVertex(int v);
+  bool isVertexDisabled(int v) const { return anyVertexDisabled_ && (*verticesDisabled_)[v]; }
+  bool isVertexIsolated(int v) const { return anyVertexIsolated_ && (*verticesIsolated_)[v]; }
+  const Weight getEdgeCost(int tail, int head) const;
+  void setEdgeCost(EdgeIdx edgeIdx, Weight cost);
+  EdgeIdx updateEdgeCosts(const std::vector<EdgeInfo> &updates);
+  uint64_t getCostVersion() const { return costVersion_; }
+  bool getDirtyEdges(uint64_t sinceVersion, std::vector<EdgeIdx> &edges) const;
+  void clearDirtyEdges();
+  EdgeIdx insertEdges(const std::vector<EdgeInfo> &edges);
+  EdgeIdx deleteEdges(const std::vector<EdgeInfo> &edges);
+  bool hasDelta() const { return delta_ != nullptr; }
+  EdgeIdx getDeltaSize() const { return delta_ ? delta_->size() : 0; }
+  size_t deltaBytes() const { return delta_ ? delta_->memoryBytes() : 0; }
+  void compactDelta(int numThreads = 0);
+  void setCompactionThreshold(double fraction, int numThreads = 0);
+  bool isCompacting() const { return compaction_ != nullptr; }
+  bool pollCompaction();
+  void waitCompaction();
+  /* whether tail -> head is an edge of the graph at all, removed or not */
+  bool hasEdge(int tail, int head) const { return getEdgeIndex(tail, head) != -1; }
+  /* both overloads count an edge as removed when its own flag is set, its
+   * tail is disabled or its head is isolated, as the iterators do */
+  const bool isRemoved(EdgeIdx edgeIdx) const;
   const bool isRemoved(int tail, int head) const;
 
   /* special for feng */
   void fengRemoveArtificialEdges(std::vector<int> &vertToRemove);
   void fengAddArtificialEdges(std::vector<int> &newExpressVertices);
   void fengSetArtificialEdge(int fromVertex, bool flag);
-  std::vector<int> getReverseTrace() const {return reverseTrace_;}
-  std::vector<int> getFirstEdgeEachV() const { return firstEdgeEachV_;}
-  std::vector<int> getFirstEdgeReverseV() const { return firstEdgeReverseV_;}
-  std::vector<EdgeInfo> getEdgeInfoList() {return edgeInfoList_;}
+  Span<const EdgeIdx> getReverseTrace() const { topology_->buildReverse(); return topology_->reverseTrace; }
+  Span<const int> getReverseTails() const { topology_->buildReverse(); return topology_->reverseTails; }
+  Span<const EdgeIdx> getFirstEdgeEachV() const { return topology_->firstEdgeEachV; }
+  Span<const EdgeIdx> getFirstEdgeReverseV() const { topology_->buildReverse(); return topology_->firstEdgeReverseV; }
+  Span<const int> getHeads() const { topology_->decompress(); return topology_->heads; }
+  Span<const Weight> getCosts() const { topology_->decompress(); return costs(); }
+  std::vector<EdgeInfo> getEdgeInfoList() const;
 };
 }
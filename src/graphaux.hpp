@@ -21,7 +21,10 @@
 */
 #pragma once
 
+#include <memory>
 #include <vector>
+#include "weight.hpp"
+#include "edgeidx.hpp"
 
 namespace haruki
 {
@@ -31,8 +34,8 @@ class EdgeInfo
 public:
   int tail;
   int head;
-  double cost;
-  EdgeInfo(int t, int h, double c)
+  Weight cost;
+  EdgeInfo(int t, int h, Weight c)
   {
     tail = t;
     head = h;
@@ -66,18 +69,41 @@ public:
   }
 };
 
+class ShortcutTable;
+
+/*
+ * What the Graph built from a GraphBuilder does with edges that repeat the
+ * (tail, head) of an earlier one: keep them all as parallel edges, keep
+ * only the first, or keep only the cheapest (the first among equals).
+ */
+enum RepeatedEdges { KEEP_ALL_REPEATED, KEEP_FIRST_REPEATED, KEEP_MIN_COST_REPEATED };
+
 class GraphBuilder
 {
 private:
   int numVert_ = 0;
   std::vector<EdgeInfo> edgeInfoList_;
+  /* ids the vertices had before being renumbered, empty if they were not */
+  std::vector<int> originalIds_;
+  /* chains behind edges that replace contracted vertices, if any */
+  std::shared_ptr<const ShortcutTable> shortcuts_;
+  RepeatedEdges repeatedEdges_ = KEEP_ALL_REPEATED;
 
 public:
   void setNumVert(int numVert) { numVert_ = numVert; edgeInfoList_.reserve(numVert); }
-  void setNumEdges(int numEdges) { edgeInfoList_.reserve(numEdges); }
+  void setNumEdges(EdgeIdx numEdges) { edgeInfoList_.reserve(numEdges); }
   int getNumVert() { return numVert_; }
-  void addEdge(int tail, int head, double cost);
+  void addEdge(int tail, int head, Weight cost);
   void addEdge(const EdgeInfo& edgeInfo);
+  /* appends edges whose endpoints are at most maxVertex */
+  void addEdges(const std::vector<EdgeInfo> &edges, int maxVertex);
   std::vector<EdgeInfo> getEdgeInfoList() { return edgeInfoList_; }
+  const std::vector<EdgeInfo> &getEdges() const { return edgeInfoList_; }
+  void setOriginalIds(std::vector<int> originalIds) { originalIds_ = originalIds; }
+  const std::vector<int> &getOriginalIds() const { return originalIds_; }
+  void setShortcuts(std::shared_ptr<const ShortcutTable> shortcuts) { shortcuts_ = shortcuts; }
+  std::shared_ptr<const ShortcutTable> getShortcuts() const { return shortcuts_; }
+  void setRepeatedEdges(RepeatedEdges repeatedEdges) { repeatedEdges_ = repeatedEdges; }
+  RepeatedEdges getRepeatedEdges() const { return repeatedEdges_; }
 };
 }
@@ -21,194 +21,443 @@
 */
 #pragma once
 
+#include <algorithm>
 #include <vector>
 #include "graphaux.hpp"
+#include "edgemask.hpp"
+#include "compressedadjacency.hpp"
+#include "deltaoverlay.hpp"
+#include "hugepage.hpp"
 
 namespace haruki
 {
   /* out */
   namespace EdgeOut {
+    /* with a compressed adjacency the heads are decoded as the iterator
+     * moves, and costs come from its dictionary when costs is empty; with
+     * a delta overlay the edges inserted at v follow those of the CSR.
+     * A disabled vertex has no edges out, edges into isolated vertices are
+     * skipped */
     class iterator
     {
-      std::vector<int> &firstEdgeEachV_;
-      std::vector<EdgeInfo> &edgeInfoList_;
-      std::vector<bool> &removed_;
-      int numEdges_;
+      const HugeVector<int> &heads_;
+      const HugeVector<Weight> &costs_;
+      const EdgeMask &removed_;
+      const CompressedAdjacency *compressed_;
+      const DeltaOverlay *delta_;
+      const EdgeMask *isolatedHeads_;
+      const uint8_t *bytes_;
+      EdgeIdx numEdges_;
+      EdgeIdx numCosts_;
       int v_;
-      int idx_;
+      EdgeIdx idx_;
+      EdgeIdx endIdx_;
+      int head_;
+      bool headCached_;
+      bool inDelta_;
+      size_t insertedPos_;
 
     public:
 
-      iterator(std::vector<int> &firstEdgeEachV, std::vector<EdgeInfo> &edgeInfoList, std::vector<bool> &removed, int numEdges, int idx)
-          : firstEdgeEachV_{firstEdgeEachV}, edgeInfoList_{edgeInfoList}, removed_{removed}, numEdges_{numEdges}, idx_{idx}
+      iterator(const HugeVector<int> &heads, const HugeVector<Weight> &costs, const EdgeMask &removed, EdgeIdx numEdges, EdgeIdx idx)
+          : heads_{heads}, costs_{costs}, removed_{removed}, compressed_{nullptr}, delta_{nullptr}, isolatedHeads_{nullptr}, bytes_{nullptr}, numEdges_{numEdges}, numCosts_{0}, v_{-1}, idx_{idx}, endIdx_{idx}, head_{-1}, headCached_{false}, inDelta_{false}, insertedPos_{0}
       {
       }
 
-      iterator(std::vector<EdgeInfo> &edgeInfoList, std::vector<int> &firstEdgeEachV, std::vector<bool> &removed, int numVert, int numEdges, int v)
-          : firstEdgeEachV_{firstEdgeEachV}, edgeInfoList_{edgeInfoList}, removed_{removed}, numEdges_{numEdges}, v_{v}
+      iterator(const HugeVector<EdgeIdx> &firstEdgeEachV, const HugeVector<int> &heads, const HugeVector<Weight> &costs, const EdgeMask &removed, int numVert, EdgeIdx numEdges, int v, const CompressedAdjacency *compressed = nullptr, const DeltaOverlay *delta = nullptr, const EdgeMask *disabledVertices = nullptr, const EdgeMask *isolatedVertices = nullptr)
+          : heads_{heads}, costs_{costs}, removed_{removed}, compressed_{compressed}, delta_{delta}, isolatedHeads_{isolatedVertices}, bytes_{nullptr}, numEdges_{numEdges}, numCosts_(costs.size()), v_{v}, head_{-1}, headCached_{compressed != nullptr}, inDelta_{false}, insertedPos_{0}
       {
+        if (disabledVertices && (*disabledVertices)[v])
+        {
+          idx_ = endIdx_ = numEdges;
+          return;
+        }
         idx_ = firstEdgeEachV[v];
-        while (idx_ < numEdges_ && idx_ < firstEdgeEachV_[v_ + 1] && removed_[idx_]) {
-          idx_++;
+        endIdx_ = (v + 1 < numVert ? firstEdgeEachV[v + 1] : (delta ? delta->baseEdges : numEdges));
+        if (compressed_)
+        {
+          bytes_ = compressed_->headBytes(v);
+          if (idx_ < endIdx_)
+          {
+            head_ = CompressedAdjacency::readFirstHead(bytes_, v);
+          }
+          skipRemovedCompressed();
         }
-        if (v < numVert - 1 && idx_ == firstEdgeEachV[v + 1])
+        else
         {
-          idx_ = numEdges;
+          skipRemoved();
         }
       }
 
-      EdgeInfo operator*() const { return edgeInfoList_[idx_]; }
+      EdgeInfo operator*() const { return EdgeInfo(v_, head(), cost()); }
+      int head() const { return headCached_ ? head_ : heads_[idx_]; }
+      Weight cost() const { return idx_ < numCosts_ ? costs_[idx_] : slowCost(); }
 
       iterator &operator++()
       {
+        if (inDelta_)
+        {
+          insertedPos_++;
+          skipRemovedInserted();
+          return *this;
+        }
         idx_++;
-        while (idx_ < numEdges_ && idx_ < firstEdgeEachV_[v_ + 1] && removed_[idx_]) {
-          idx_++;
+        if (compressed_)
+        {
+          if (idx_ < endIdx_)
+          {
+            head_ += CompressedAdjacency::readVarint(bytes_);
+          }
+          skipRemovedCompressed();
         }
-        if (idx_ < numEdges_ && edgeInfoList_[idx_].tail != v_) {
-          idx_ = numEdges_;
+        else
+        {
+          skipRemoved();
         }
         return *this;
       }
 
       bool operator!=(const iterator &o) const { return idx_ != o.idx_; }
 
-      int getEdgeIdx() {
+      EdgeIdx getEdgeIdx() {
         return idx_;
       }
+
+    private:
+      Weight slowCost() const
+      {
+        if (delta_ && idx_ >= delta_->baseEdges)
+        {
+          return delta_->costs[idx_ - delta_->baseEdges];
+        }
+        return compressed_->cost(idx_);
+      }
+
+      bool headIsolated(int head) const { return isolatedHeads_ && (*isolatedHeads_)[head]; }
+
+      void skipRemoved()
+      {
+        idx_ = removed_.nextEnabled(idx_, endIdx_);
+        while (isolatedHeads_ && idx_ < endIdx_ && (*isolatedHeads_)[heads_[idx_]]) {
+          idx_ = removed_.nextEnabled(idx_ + 1, endIdx_);
+        }
+        if (idx_ >= endIdx_) {
+          endOfCsr();
+        }
+      }
+
+      /* heads of the skipped edges still have to be decoded */
+      void skipRemovedCompressed()
+      {
+        while (idx_ < endIdx_ && (removed_[idx_] || headIsolated(head_))) {
+          idx_++;
+          if (idx_ < endIdx_) {
+            head_ += CompressedAdjacency::readVarint(bytes_);
+          }
+        }
+        if (idx_ >= endIdx_) {
+          endOfCsr();
+        }
+      }
+
+      void endOfCsr()
+      {
+        if (delta_ && !delta_->out[v_].empty()) {
+          inDelta_ = true;
+          headCached_ = true;
+          skipRemovedInserted();
+        }
+        else {
+          idx_ = numEdges_;
+        }
+      }
+
+      void skipRemovedInserted()
+      {
+        const std::vector<EdgeIdx> &inserted = delta_->out[v_];
+        while (insertedPos_ < inserted.size() && (removed_[inserted[insertedPos_]] || headIsolated(delta_->heads[inserted[insertedPos_] - delta_->baseEdges]))) {
+          insertedPos_++;
+        }
+        if (insertedPos_ < inserted.size()) {
+          idx_ = inserted[insertedPos_];
+          head_ = delta_->heads[idx_ - delta_->baseEdges];
+        }
+        else {
+          idx_ = numEdges_;
+        }
+      }
     };
 
     class range
     {
-      std::vector<int> &firstEdgeEachV_;
-      std::vector<EdgeInfo> &edgeInfoList_;
-      std::vector<bool> &removed_;
+      const HugeVector<int> &heads_;
+      const HugeVector<Weight> &costs_;
+      const EdgeMask &removed_;
       iterator begin_it_;
-      int numEdges_;
+      EdgeIdx numEdges_;
 
     public:
-      range(std::vector<EdgeInfo> &edgeInfoList, std::vector<int> &firstEdgeEachV, std::vector<bool> &removed, int numVert, int numEdges, int v)
-          : firstEdgeEachV_{firstEdgeEachV}, edgeInfoList_{edgeInfoList}, removed_{removed}, begin_it_{iterator(edgeInfoList, firstEdgeEachV, removed, numVert, numEdges, v)}, numEdges_{numEdges} {}
+      range(const HugeVector<EdgeIdx> &firstEdgeEachV, const HugeVector<int> &heads, const HugeVector<Weight> &costs, const EdgeMask &removed, int numVert, EdgeIdx numEdges, int v, const CompressedAdjacency *compressed = nullptr, const DeltaOverlay *delta = nullptr, const EdgeMask *disabledVertices = nullptr, const EdgeMask *isolatedVertices = nullptr)
+          : heads_{heads}, costs_{costs}, removed_{removed}, begin_it_{iterator(firstEdgeEachV, heads, costs, removed, numVert, numEdges, v, compressed, delta, disabledVertices, isolatedVertices)}, numEdges_{numEdges} {}
 
       iterator begin() const { return begin_it_; }
-      iterator end() const { return iterator(firstEdgeEachV_, edgeInfoList_, removed_, numEdges_, numEdges_); }
+      iterator end() const { return iterator(heads_, costs_, removed_, numEdges_, numEdges_); }
     };
   }
 
   /* in */
   namespace EdgeIn {
+    /* while in the CSR idx is a position in the reverse arrays, then the
+     * index of the inserted edge; the two ranges do not overlap. Edges out
+     * of disabled vertices are skipped, an isolated vertex has no edges in.
+     *
+     * On a symmetric topology the forward arrays are passed in place of the
+     * reverse ones: the edges into v are walked in the order of those out
+     * of v, and each edge index is looked up in the adjacency of its tail */
     class iterator
     {
-      std::vector<int> &firstEdgeReverseV_;
-      std::vector<int> &reverseTrace_;
-      std::vector<EdgeInfo> &edgeInfoList_;
-      std::vector<bool> &removed_;
-      int numEdges_;
-      int idx_;
+      const HugeVector<EdgeIdx> &firstEdgeReverseV_;
+      const HugeVector<EdgeIdx> &reverseTrace_;
+      const HugeVector<int> &reverseTails_;
+      const HugeVector<Weight> &costs_;
+      const EdgeMask &removed_;
+      const DeltaOverlay *delta_;
+      const EdgeMask *disabledTails_;
+      int numVert_;
+      EdgeIdx numEdges_;
       int v_;
+      EdgeIdx idx_;
+      EdgeIdx endIdx_;
+      EdgeIdx edge_;
+      bool symmetric_;
+      bool inDelta_;
+      size_t insertedPos_;
 
     public:
-      iterator(std::vector<int> &firstEdgeReverseV, std::vector<EdgeInfo> &edgeInfoList, std::vector<int> &reverseTrace, std::vector<bool> &removed, int numEdges, int idx)
-          : firstEdgeReverseV_{firstEdgeReverseV}, reverseTrace_{reverseTrace}, edgeInfoList_{edgeInfoList}, removed_{removed}, numEdges_{numEdges}, idx_{idx}
+      iterator(const HugeVector<EdgeIdx> &reverseTrace, const HugeVector<int> &reverseTails, const HugeVector<Weight> &costs, const EdgeMask &removed, EdgeIdx numEdges, EdgeIdx idx)
+          : firstEdgeReverseV_{reverseTrace}, reverseTrace_{reverseTrace}, reverseTails_{reverseTails}, costs_{costs}, removed_{removed}, delta_{nullptr}, disabledTails_{nullptr}, numVert_{0}, numEdges_{numEdges}, v_{-1}, idx_{idx}, endIdx_{idx}, edge_{idx}, symmetric_{false}, inDelta_{false}, insertedPos_{0}
       {
       }
 
-      iterator(std::vector<EdgeInfo> &edgeInfoList, std::vector<int> &firstEdgeReverseV, std::vector<int> &reverseTrace, std::vector<bool> &removed, int numVert, int numEdges, int v)
-          : firstEdgeReverseV_{firstEdgeReverseV}, reverseTrace_{reverseTrace}, edgeInfoList_{edgeInfoList}, removed_{removed}, numEdges_{numEdges}, v_{v}
+      iterator(const HugeVector<EdgeIdx> &firstEdgeReverseV, const HugeVector<EdgeIdx> &reverseTrace, const HugeVector<int> &reverseTails, const HugeVector<Weight> &costs, const EdgeMask &removed, int numVert, EdgeIdx numEdges, int v, const DeltaOverlay *delta = nullptr, const EdgeMask *disabledVertices = nullptr, bool symmetric = false, const EdgeMask *isolatedVertices = nullptr)
+          : firstEdgeReverseV_{firstEdgeReverseV}, reverseTrace_{reverseTrace}, reverseTails_{reverseTails}, costs_{costs}, removed_{removed}, delta_{delta}, disabledTails_{disabledVertices}, numVert_{numVert}, numEdges_{numEdges}, v_{v}, symmetric_{symmetric}, inDelta_{false}, insertedPos_{0}
       {
-        idx_ = firstEdgeReverseV_[v];
-        while (idx_ < numEdges_ && idx_ < firstEdgeReverseV_[v_ + 1] && removed_[reverseTrace_[idx_]]) {
-          idx_++;
-        }
-        if (v < numVert - 1 && idx_ == firstEdgeReverseV_[v + 1])
+        if (isolatedVertices && (*isolatedVertices)[v])
         {
-          idx_ = numEdges;
+          idx_ = endIdx_ = edge_ = numEdges;
+          return;
         }
+        idx_ = firstEdgeReverseV[v];
+        endIdx_ = csrEnd(v);
+        skipRemoved();
       }
 
-      EdgeInfo operator*() const { return edgeInfoList_[reverseTrace_[idx_]]; }
+      EdgeInfo operator*() const { return EdgeInfo(tail(), v_, cost()); }
+      int tail() const { return inDelta_ ? delta_->tails[idx_ - delta_->baseEdges] : reverseTails_[idx_]; }
+      Weight cost() const
+      {
+        EdgeIdx edgeIdx = edge();
+        if (edgeIdx < (EdgeIdx)costs_.size()) {
+          return costs_[edgeIdx];
+        }
+        return delta_->costs[edgeIdx - delta_->baseEdges];
+      }
 
       iterator &operator++()
       {
-        idx_++;
-        while (idx_ < numEdges_ && idx_ < firstEdgeReverseV_[v_ + 1] && removed_[reverseTrace_[idx_]]) {
-          idx_++;
-        }
-        if (idx_ < numEdges_ && edgeInfoList_[reverseTrace_[idx_]].head != v_) {
-          idx_ = numEdges_;
+        if (inDelta_)
+        {
+          insertedPos_++;
+          skipRemovedInserted();
+          return *this;
         }
+        idx_++;
+        skipRemoved();
         return *this;
       }
 
       bool operator!=(const iterator &o) const { return idx_ != o.idx_; }
 
-      int getEdgeIdx() {
-        return reverseTrace_[idx_];
+      EdgeIdx getEdgeIdx() {
+        return edge();
+      }
+
+    private:
+      EdgeIdx edge() const { return inDelta_ ? idx_ : edge_; }
+
+      bool tailDisabled(int tail) const { return disabledTails_ && (*disabledTails_)[tail]; }
+
+      EdgeIdx csrEnd(int v) const
+      {
+        return v + 1 < numVert_ ? firstEdgeReverseV_[v + 1] : (delta_ ? delta_->baseEdges : numEdges_);
+      }
+
+      /* index of the edge at position pos of the reverse arrays */
+      EdgeIdx edgeAt(EdgeIdx pos) const
+      {
+        if (!symmetric_) {
+          return reverseTrace_[pos];
+        }
+        int tail = reverseTails_[pos];
+        const int *first = reverseTails_.data();
+        return std::lower_bound(first + firstEdgeReverseV_[tail], first + csrEnd(tail), v_) - first;
+      }
+
+      void skipRemoved()
+      {
+        while (idx_ < endIdx_) {
+          edge_ = edgeAt(idx_);
+          if (!removed_[edge_] && !tailDisabled(reverseTails_[idx_])) {
+            break;
+          }
+          idx_++;
+        }
+        if (idx_ >= endIdx_) {
+          if (delta_ && !delta_->in[v_].empty()) {
+            inDelta_ = true;
+            skipRemovedInserted();
+          }
+          else {
+            idx_ = numEdges_;
+          }
+        }
+      }
+
+      void skipRemovedInserted()
+      {
+        const std::vector<EdgeIdx> &inserted = delta_->in[v_];
+        while (insertedPos_ < inserted.size() && (removed_[inserted[insertedPos_]] || tailDisabled(delta_->tails[inserted[insertedPos_] - delta_->baseEdges]))) {
+          insertedPos_++;
+        }
+        idx_ = (insertedPos_ < inserted.size() ? inserted[insertedPos_] : numEdges_);
       }
     };
 
     class range
     {
-      std::vector<int> &firstEdgeReverseV_;
-      std::vector<int> &reverseTrace_;
-      std::vector<EdgeInfo> &edgeInfoList_;
-      std::vector<bool> &removed_;
+      const HugeVector<EdgeIdx> &reverseTrace_;
+      const HugeVector<int> &reverseTails_;
+      const HugeVector<Weight> &costs_;
+      const EdgeMask &removed_;
       iterator begin_it_;
-      int numEdges_;
+      EdgeIdx numEdges_;
 
     public:
-      range(std::vector<EdgeInfo> &edgeInfoList, std::vector<int> &firstEdgeReverseV, std::vector<int> &reverseTrace, std::vector<bool> &removed, int numVert, int numEdges, int v)
-          : firstEdgeReverseV_{firstEdgeReverseV}, reverseTrace_{reverseTrace}, edgeInfoList_{edgeInfoList}, removed_{removed}, begin_it_{iterator(edgeInfoList, firstEdgeReverseV, reverseTrace, removed, numVert, numEdges, v)}, numEdges_{numEdges} {}
+      range(const HugeVector<EdgeIdx> &firstEdgeReverseV, const HugeVector<EdgeIdx> &reverseTrace, const HugeVector<int> &reverseTails, const HugeVector<Weight> &costs, const EdgeMask &removed, int numVert, EdgeIdx numEdges, int v, const DeltaOverlay *delta = nullptr, const EdgeMask *disabledVertices = nullptr, bool symmetric = false, const EdgeMask *isolatedVertices = nullptr)
+          : reverseTrace_{reverseTrace}, reverseTails_{reverseTails}, costs_{costs}, removed_{removed}, begin_it_{iterator(firstEdgeReverseV, reverseTrace, reverseTails, costs, removed, numVert, numEdges, v, delta, disabledVertices, symmetric, isolatedVertices)}, numEdges_{numEdges} {}
 
       iterator begin() const { return begin_it_; }
-      iterator end() const { return iterator(firstEdgeReverseV_, edgeInfoList_, reverseTrace_, removed_, numEdges_, numEdges_); }
+      iterator end() const { return iterator(reverseTrace_, reverseTails_, costs_, removed_, numEdges_, numEdges_); }
     };
   }
 
-  /* all edges (to do) */
+  /* all edges */
   namespace EdgeList {
+    /* walks the mask one word at a time, flags changed during the walk are
+     * only seen from the next word on; edges inserted by a delta overlay
+     * come after all the others. Edges out of disabled vertices and into
+     * isolated ones are skipped */
     class iterator
     {
-      std::vector<EdgeInfo>::iterator it_;
-      std::vector<bool>::iterator removedIt_;
+      const HugeVector<EdgeIdx> &firstEdgeEachV_;
+      const HugeVector<int> &heads_;
+      const HugeVector<Weight> &costs_;
+      const EdgeMask &removed_;
+      const DeltaOverlay *delta_;
+      const EdgeMask *disabledTails_;
+      const EdgeMask *isolatedHeads_;
+      int numVert_;
+      EdgeIdx numEdges_;
+      EdgeIdx baseEdges_;
+      int v_;
+      EdgeIdx idx_;
+      EdgeIdx word_;
+      uint64_t enabled_;
 
     public:
-      iterator(std::vector<EdgeInfo>::iterator it, std::vector<bool>::iterator removedIt)
-      : it_{it}, removedIt_{removedIt}
+      iterator(const HugeVector<EdgeIdx> &firstEdgeEachV, const HugeVector<int> &heads, const HugeVector<Weight> &costs, const EdgeMask &removed, int numVert, EdgeIdx numEdges, EdgeIdx idx, const DeltaOverlay *delta = nullptr, const EdgeMask *disabledVertices = nullptr, const EdgeMask *isolatedVertices = nullptr)
+      : firstEdgeEachV_{firstEdgeEachV}, heads_{heads}, costs_{costs}, removed_{removed}, delta_{delta}, disabledTails_{disabledVertices}, isolatedHeads_{isolatedVertices}, numVert_{numVert}, numEdges_{numEdges}, baseEdges_{delta ? delta->baseEdges : numEdges}, v_{0}, idx_{idx}
       {
-        while (*removedIt_) {
-          ++it_;
-          ++removedIt_;
-        }
+        word_ = idx >> 6;
+        enabled_ = (idx < numEdges ? removed_.enabledBits(word_) & (~0ull << (idx & 63)) : 0);
+        nextEnabled();
       }
 
-      EdgeInfo& operator*() const { return *it_; }
+      EdgeInfo operator*() const
+      {
+        if (idx_ < baseEdges_) {
+          return EdgeInfo(v_, heads_[idx_], costs_[idx_]);
+        }
+        EdgeIdx i = idx_ - baseEdges_;
+        Weight cost = (idx_ < (EdgeIdx)costs_.size() ? costs_[idx_] : delta_->costs[i]);
+        return EdgeInfo(delta_->tails[i], delta_->heads[i], cost);
+      }
 
       iterator &operator++()
       {
-        ++it_;
-        ++removedIt_;
-        while (*removedIt_) {
-          ++it_;
-          ++removedIt_;
-        }
+        nextEnabled();
         return *this;
       }
 
-      bool operator!=(const iterator &o) const { return it_ != o.it_; }
+      bool operator!=(const iterator &o) const { return idx_ != o.idx_; }
+
+      EdgeIdx getEdgeIdx() {
+        return idx_;
+      }
+
+    private:
+      int tail() const { return idx_ < baseEdges_ ? v_ : delta_->tails[idx_ - baseEdges_]; }
+      int head() const { return idx_ < baseEdges_ ? heads_[idx_] : delta_->heads[idx_ - baseEdges_]; }
+
+      void nextEnabled()
+      {
+        do {
+          nextFlagEnabled();
+        } while (idx_ != numEdges_ && ((disabledTails_ && (*disabledTails_)[tail()]) || (isolatedHeads_ && (*isolatedHeads_)[head()])));
+      }
+
+      void nextFlagEnabled()
+      {
+        while (enabled_ == 0) {
+          word_++;
+          if ((word_ << 6) >= numEdges_) {
+            idx_ = numEdges_;
+            return;
+          }
+          enabled_ = removed_.enabledBits(word_);
+        }
+        idx_ = (word_ << 6) + __builtin_ctzll(enabled_);
+        enabled_ &= enabled_ - 1;
+        if (idx_ >= numEdges_) {
+          idx_ = numEdges_;
+          enabled_ = 0;
+          return;
+        }
+        /* edges are sorted by tail, so the tail only moves forward */
+        while (v_ + 1 < numVert_ && firstEdgeEachV_[v_ + 1] <= idx_ && idx_ < baseEdges_) {
+          v_++;
+        }
+      }
     };
 
     class range
     {
-      std::vector<EdgeInfo> &edgeInfoList_;
-      std::vector<bool> &removed_;
+      const HugeVector<EdgeIdx> &firstEdgeEachV_;
+      const HugeVector<int> &heads_;
+      const HugeVector<Weight> &costs_;
+      const EdgeMask &removed_;
+      const DeltaOverlay *delta_;
+      const EdgeMask *disabledVertices_;
+      const EdgeMask *isolatedVertices_;
+      int numVert_;
+      EdgeIdx numEdges_;
 
     public:
-      range(std::vector<EdgeInfo> &edgeInfoList, std::vector<bool> &removed)
-          : edgeInfoList_{edgeInfoList}, removed_{removed} {}
+      range(const HugeVector<EdgeIdx> &firstEdgeEachV, const HugeVector<int> &heads, const HugeVector<Weight> &costs, const EdgeMask &removed, int numVert, EdgeIdx numEdges, const DeltaOverlay *delta = nullptr, const EdgeMask *disabledVertices = nullptr, const EdgeMask *isolatedVertices = nullptr)
+          : firstEdgeEachV_{firstEdgeEachV}, heads_{heads}, costs_{costs}, removed_{removed}, delta_{delta}, disabledVertices_{disabledVertices}, isolatedVertices_{isolatedVertices}, numVert_{numVert}, numEdges_{numEdges} {}
 
-      iterator begin() const { return iterator(edgeInfoList_.begin(), removed_.begin()); }
-      iterator end() const { return iterator(edgeInfoList_.end(), removed_.end()); }
+      iterator begin() const { return iterator(firstEdgeEachV_, heads_, costs_, removed_, numVert_, numEdges_, 0, delta_, disabledVertices_, isolatedVertices_); }
+      iterator end() const { return iterator(firstEdgeEachV_, heads_, costs_, removed_, numVert_, numEdges_, numEdges_); }
     };
   }
 }
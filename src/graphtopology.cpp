@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2018 Diogo Haruki Kykuta
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+*/
+#include "graphtopology.hpp"
+#include <algorithm>
+#include "parallel.hpp"
+
+namespace haruki
+{
+
+std::shared_ptr<GraphTopology> GraphTopology::clone() const
+{
+  std::shared_ptr<GraphTopology> topology = std::make_shared<GraphTopology>();
+  topology->firstEdgeEachV = firstEdgeEachV;
+  topology->heads = heads;
+  topology->costs = costs;
+  topology->firstEdgeReverseV = firstEdgeReverseV;
+  topology->reverseTrace = reverseTrace;
+  topology->reverseTails = reverseTails;
+  topology->originalIds = originalIds;
+  topology->internalIds = internalIds;
+  topology->shortcuts = shortcuts;
+  topology->compressed = compressed;
+  topology->symmetric = symmetric;
+  topology->numVert = numVert;
+  topology->numEdges = numEdges;
+  return topology;
+}
+
+/*
+ * Compacts each run of edges with the same tail and head to one edge in
+ * place, vertices in parallel, then closes the gaps between vertices.
+ */
+void GraphTopology::removeRepeatedEdges(RepeatedEdges policy, int numThreads)
+{
+  if (policy == KEEP_ALL_REPEATED)
+  {
+    return;
+  }
+
+  std::vector<EdgeIdx> numKept(numVert, 0);
+  parallelFor(numThreads, 0, numVert, [&](long long begin, long long end, int t) {
+    for (long long v = begin; v < end; v++)
+    {
+      EdgeIdx first = firstEdgeEachV[v];
+      EdgeIdx endIdx = (v + 1 < numVert ? firstEdgeEachV[v + 1] : numEdges);
+      EdgeIdx kept = first;
+      for (EdgeIdx idx = first; idx < endIdx; idx++)
+      {
+        if (kept > first && heads[idx] == heads[kept - 1])
+        {
+          if (policy == KEEP_MIN_COST_REPEATED && costs[idx] < costs[kept - 1])
+          {
+            costs[kept - 1] = costs[idx];
+          }
+          continue;
+        }
+        heads[kept] = heads[idx];
+        costs[kept] = costs[idx];
+        kept++;
+      }
+      numKept[v] = kept - first;
+    }
+  });
+
+  EdgeIdx kept = 0;
+  for (int v = 0; v < numVert; v++)
+  {
+    EdgeIdx first = firstEdgeEachV[v];
+    firstEdgeEachV[v] = kept;
+    if (first != kept)
+    {
+      std::copy(heads.begin() + first, heads.begin() + first + numKept[v], heads.begin() + kept);
+      std::copy(costs.begin() + first, costs.begin() + first + numKept[v], costs.begin() + kept);
+    }
+    kept += numKept[v];
+  }
+  if (kept == numEdges)
+  {
+    return;
+  }
+  numEdges = kept;
+  heads.resize(kept);
+  heads.shrink_to_fit();
+  costs.resize(kept);
+  costs.shrink_to_fit();
+}
+
+/* counting sort of the edges by head; as edges are visited in (tail, head)
+ * order, each head ends up with its incoming edges sorted by tail */
+void GraphTopology::fillReverse() const
+{
+  if ((EdgeIdx)reverseTrace.size() == numEdges && (int)firstEdgeReverseV.size() == numVert)
+  {
+    return;
+  }
+
+  firstEdgeReverseV = HugeVector<EdgeIdx>(numVert, 0);
+  forEachEdge([this](int tail, EdgeIdx idx, int head) {
+    if (head + 1 < numVert)
+    {
+      firstEdgeReverseV[head + 1]++;
+    }
+  });
+  for (int v = 1; v < numVert; v++)
+  {
+    firstEdgeReverseV[v] += firstEdgeReverseV[v - 1];
+  }
+
+  HugeVector<EdgeIdx> next = firstEdgeReverseV;
+  reverseTrace = HugeVector<EdgeIdx>(numEdges);
+  reverseTails = HugeVector<int>(numEdges);
+  forEachEdge([this, &next](int tail, EdgeIdx idx, int head) {
+    EdgeIdx pos = next[head]++;
+    reverseTrace[pos] = idx;
+    reverseTails[pos] = tail;
+  });
+}
+
+void GraphTopology::fillDecompressed() const
+{
+  if ((EdgeIdx)heads.size() != numEdges)
+  {
+    compressed->decodeHeads(firstEdgeEachV, numVert, numEdges, heads);
+  }
+  if ((EdgeIdx)costs.size() != numEdges)
+  {
+    compressed->decodeCosts(numEdges, costs);
+  }
+}
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2018 Diogo Haruki Kykuta
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include "compressedadjacency.hpp"
+#include "edgeidx.hpp"
+#include "graphaux.hpp"
+#include "hugepage.hpp"
+#include "shortcuts.hpp"
+
+namespace haruki
+{
+
+class MappedFile;
+
+/*
+ * Read-only part of a Graph: the forward and reverse adjacency and the
+ * base edge costs. It is built once and shared by every Graph created from
+ * it, each of which keeps its own removal mask and rewritten costs.
+ *
+ * Only Feng and Hybrid walk incoming edges, so the reverse adjacency is
+ * built the first time buildReverse() is called, unless whoever built the
+ * topology already filled it.
+ *
+ * A compressed topology (see Graph::compress()) leaves heads, and costs when
+ * they are dictionary coded, empty; decompress() fills them back for the
+ * code that needs random access to them.
+ *
+ * A topology loaded from a snapshot has its arrays view the mapped file,
+ * which it keeps open: they are read-only, and a graph clones the topology
+ * before writing to it in place.
+ */
+struct GraphTopology
+{
+  /* declared first, so the file outlives the arrays that view it */
+  std::shared_ptr<const MappedFile> mapping;
+  /* edges are kept as a struct of arrays: heads and costs are indexed by
+   * the offsets in firstEdgeEachV, reverseTails follows reverseTrace */
+  HugeVector<EdgeIdx> firstEdgeEachV;
+  mutable HugeVector<int> heads;
+  mutable HugeVector<Weight> costs;
+  mutable HugeVector<EdgeIdx> firstEdgeReverseV;
+  mutable HugeVector<EdgeIdx> reverseTrace;
+  mutable HugeVector<int> reverseTails;
+  /* set when the vertices were renumbered (see reorder.hpp, trim.hpp):
+   * vertex v was originalIds[v] in the input and internalIds is its
+   * inverse, -1 for input vertices left out */
+  std::vector<int> originalIds;
+  std::vector<int> internalIds;
+  /* set when chains of vertices were contracted, see contract.hpp */
+  std::shared_ptr<const ShortcutTable> shortcuts;
+  std::shared_ptr<const CompressedAdjacency> compressed;
+  /* every edge has a twin in the opposite direction (Graph::useSymmetricStorage):
+   * edges into a vertex are served from the forward arrays, the reverse
+   * ones are only filled for code that asks for them */
+  bool symmetric = false;
+  int numVert = 0;
+  EdgeIdx numEdges = 0;
+
+  GraphTopology() {}
+  GraphTopology(const GraphTopology &) = delete;
+  GraphTopology &operator=(const GraphTopology &) = delete;
+
+  /* deep copy of the arrays, the compressed adjacency is shared */
+  std::shared_ptr<GraphTopology> clone() const;
+
+  /* for topologies being built: each adjacency has to be sorted by head
+   * with repeated edges in input order. The arrays are reallocated only
+   * if some edge was dropped */
+  void removeRepeatedEdges(RepeatedEdges policy, int numThreads = 1);
+
+  void buildReverse() const
+  {
+    std::call_once(reverseOnce_, [this]() { fillReverse(); });
+  }
+
+  void decompress() const
+  {
+    if (compressed)
+    {
+      std::call_once(decompressOnce_, [this]() { fillDecompressed(); });
+    }
+  }
+
+  /* calls f(tail, idx, head) for every edge in index order, decoding the
+   * heads on the fly if they are only kept compressed */
+  template <class F>
+  void forEachEdge(F f) const
+  {
+    bool decode = ((EdgeIdx)heads.size() != numEdges);
+    const uint8_t *p = (decode && numVert > 0 ? compressed->headBytes(0) : nullptr);
+    int tail = 0;
+    int head = 0;
+    for (EdgeIdx idx = 0; idx < numEdges; idx++)
+    {
+      while (tail + 1 < numVert && firstEdgeEachV[tail + 1] <= idx)
+      {
+        tail++;
+      }
+      if (!decode)
+      {
+        head = heads[idx];
+      }
+      else if (idx == firstEdgeEachV[tail])
+      {
+        head = CompressedAdjacency::readFirstHead(p, tail);
+      }
+      else
+      {
+        head += CompressedAdjacency::readVarint(p);
+      }
+      f(tail, idx, head);
+    }
+  }
+
+private:
+  mutable std::once_flag reverseOnce_;
+  mutable std::once_flag decompressOnce_;
+  void fillReverse() const;
+  void fillDecompressed() const;
+};
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2018 Diogo Haruki Kykuta
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+*/
+#include "hugepage.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <cstdint>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace haruki
+{
+namespace hugepage
+{
+
+static std::atomic<int> currentMode(SYSTEM);
+
+void setMode(Mode mode)
+{
+  currentMode.store(mode);
+}
+
+Mode getMode()
+{
+  return (Mode)currentMode.load();
+}
+
+bool parseMode(const std::string &name, Mode &mode)
+{
+  if (name == "off")
+  {
+    mode = SMALL;
+  }
+  else if (name == "system")
+  {
+    mode = SYSTEM;
+  }
+  else if (name == "thp")
+  {
+    mode = TRANSPARENT;
+  }
+  else if (name == "hugetlb")
+  {
+    mode = EXPLICIT;
+  }
+  else
+  {
+    return false;
+  }
+  return true;
+}
+
+static size_t mappedBytes(size_t bytes)
+{
+  return (bytes + kHugePageBytes - 1) / kHugePageBytes * kHugePageBytes;
+}
+
+#ifdef __linux__
+/* maps one huge page more than needed and trims both ends, so that the
+ * region starts at a huge page boundary */
+static void *mapAligned(size_t length)
+{
+  void *raw = mmap(nullptr, length + kHugePageBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (raw == MAP_FAILED)
+  {
+    return nullptr;
+  }
+  uintptr_t start = (uintptr_t)raw;
+  uintptr_t aligned = (start + kHugePageBytes - 1) / kHugePageBytes * kHugePageBytes;
+  if (aligned > start)
+  {
+    munmap(raw, aligned - start);
+  }
+  size_t tail = start + length + kHugePageBytes - (aligned + length);
+  if (tail > 0)
+  {
+    munmap((void *)(aligned + length), tail);
+  }
+  return (void *)aligned;
+}
+#endif
+
+void *allocate(size_t bytes)
+{
+  if (bytes == 0)
+  {
+    bytes = 1;
+  }
+#ifdef __linux__
+  if (bytes >= kHugePageBytes)
+  {
+    size_t length = mappedBytes(bytes);
+    Mode mode = getMode();
+    void *p = nullptr;
+    if (mode == EXPLICIT)
+    {
+      p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+      if (p == MAP_FAILED)
+      {
+        p = nullptr;
+        mode = TRANSPARENT;
+      }
+    }
+    if (p == nullptr)
+    {
+      p = mapAligned(length);
+      if (p == nullptr)
+      {
+        throw std::bad_alloc();
+      }
+      if (mode == TRANSPARENT)
+      {
+        madvise(p, length, MADV_HUGEPAGE);
+      }
+      else if (mode == SMALL)
+      {
+        madvise(p, length, MADV_NOHUGEPAGE);
+      }
+    }
+    return p;
+  }
+#endif
+  void *p = nullptr;
+  if (posix_memalign(&p, kCacheLineBytes, bytes) != 0)
+  {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void deallocate(void *p, size_t bytes)
+{
+#ifdef __linux__
+  if (bytes >= kHugePageBytes)
+  {
+    munmap(p, mappedBytes(bytes));
+    return;
+  }
+#endif
+  free(p);
+}
+}
+}
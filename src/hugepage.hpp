@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2018 Diogo Haruki Kykuta
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace haruki
+{
+namespace hugepage
+{
+/*
+ * How large arrays (see HugePageAllocator) are backed:
+ * SMALL asks the kernel not to use huge pages for them, SYSTEM leaves it to
+ * the kernel policy, TRANSPARENT asks for transparent huge pages
+ * (madvise) and EXPLICIT for pages from the hugetlb pool (MAP_HUGETLB),
+ * falling back to TRANSPARENT when the pool is empty.
+ */
+enum Mode {SMALL, SYSTEM, TRANSPARENT, EXPLICIT};
+
+/* applies to arrays allocated from then on */
+void setMode(Mode mode);
+Mode getMode();
+/* "off", "system", "thp" or "hugetlb"; returns false for anything else */
+bool parseMode(const std::string &name, Mode &mode);
+
+/* allocations this large are mapped on their own, aligned to a huge page */
+const size_t kHugePageBytes = 2 << 20;
+const size_t kCacheLineBytes = 64;
+
+void *allocate(size_t bytes);
+void deallocate(void *p, size_t bytes);
+}
+
+/*
+ * Allocator for the large, randomly accessed arrays: the CSR of a graph and
+ * the per-search arrays of Dijkstra. Everything is aligned to a cache line;
+ * arrays of at least kHugePageBytes are mapped with the current mode.
+ * Whether memory was mapped depends only on its size, so it is released
+ * correctly even if the mode changed meanwhile.
+ *
+ * An allocator made from a view hands out those n elements, as they are,
+ * to a vector of exactly n elements: the vector then reads memory owned by
+ * someone else (a snapshot file, see snapshot.hpp) and must not be written
+ * to. Copies of such a vector own their elements again; moves keep the view.
+ */
+template <class T>
+class HugePageAllocator
+{
+  T *view_;
+  size_t viewSize_;
+
+  bool inView(const void *p) const { return view_ && p >= (const void *)view_ && p < (const void *)(view_ + viewSize_); }
+
+public:
+  typedef T value_type;
+  typedef std::true_type propagate_on_container_move_assignment;
+  typedef std::true_type propagate_on_container_swap;
+
+  HugePageAllocator() : view_(nullptr), viewSize_(0) {}
+  HugePageAllocator(const T *view, size_t n) : view_(const_cast<T *>(view)), viewSize_(n) {}
+  template <class U>
+  HugePageAllocator(const HugePageAllocator<U> &) : view_(nullptr), viewSize_(0) {}
+
+  HugePageAllocator select_on_container_copy_construction() const { return HugePageAllocator(); }
+  const void *view() const { return view_; }
+
+  T *allocate(size_t n)
+  {
+    if (view_ && n == viewSize_)
+    {
+      return view_;
+    }
+    return static_cast<T *>(hugepage::allocate(n * sizeof(T)));
+  }
+
+  void deallocate(T *p, size_t n)
+  {
+    if (p != view_)
+    {
+      hugepage::deallocate(p, n * sizeof(T));
+    }
+  }
+
+  /* the elements of a view are already there */
+  template <class U, class... Args>
+  void construct(U *p, Args &&... args)
+  {
+    if (!inView(p))
+    {
+      ::new ((void *)p) U(std::forward<Args>(args)...);
+    }
+  }
+};
+
+template <class T, class U>
+bool operator==(const HugePageAllocator<T> &a, const HugePageAllocator<U> &b) { return a.view() == b.view(); }
+template <class T, class U>
+bool operator!=(const HugePageAllocator<T> &a, const HugePageAllocator<U> &b) { return a.view() != b.view(); }
+
+template <class T>
+using HugeVector = std::vector<T, HugePageAllocator<T> >;
+}
@@ -35,6 +35,8 @@ class HumanFriendlyKSP : private KSPAlgorithm
   public:
     std::vector<haruki::Path> run(haruki::Graph &g, int s, int t, int k) {
       haruki::Graph h = g;
+      s = g.toInternalId(s);
+      t = g.toInternalId(t);
 
       auto startAlg = std::chrono::high_resolution_clock::now();
       KSPAlgorithm::preproc(h, s, t, k);
@@ -44,6 +46,16 @@ class HumanFriendlyKSP : private KSPAlgorithm
 
       auto endCore = std::chrono::high_resolution_clock::now();
       std::vector<haruki::Path> ret = KSPAlgorithm::posproc(g, s, t, k, rawRet);
+      if (g.hasOriginalIds()) {
+        for (std::vector<haruki::Path>::iterator it = ret.begin(); it != ret.end(); ++it) {
+          *it = it->relabel(g.getOriginalIds());
+        }
+      }
+      if (g.hasShortcuts()) {
+        for (std::vector<haruki::Path>::iterator it = ret.begin(); it != ret.end(); ++it) {
+          *it = g.getShortcuts()->expand(*it);
+        }
+      }
 
       auto endPosproc = std::chrono::high_resolution_clock::now();
 
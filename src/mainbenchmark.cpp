@@ -0,0 +1,745 @@
+/*
+ * Copyright (C) 2018 Diogo Haruki Kykuta
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+*/
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+#include <sys/resource.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+#include "graph.hpp"
+#include "dimacsreader.hpp"
+#include "path.hpp"
+#include "dijkstra.hpp"
+#include "parallel.hpp"
+#include "hugepage.hpp"
+#include "contract.hpp"
+#include "snapshot.hpp"
+#include "yenksp.hpp"
+#include "ksp.hpp"
+
+using std::string;
+
+typedef std::chrono::high_resolution_clock hrk_clock;
+
+static double elapsedMs(hrk_clock::time_point start, hrk_clock::time_point end) {
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+/*
+ * (tail, head) lookups through binary search and through the edge index.
+ * Every edge is looked up once plus as many misses, in random order.
+ */
+static void benchEdgeIndex(haruki::Graph &g, double loadFactor) {
+  std::vector<std::pair<int, int> > queries;
+  haruki::EdgeList::range allEdges = g.getAllEdges();
+  for (haruki::EdgeList::iterator it = allEdges.begin(); it != allEdges.end(); ++it) {
+    queries.push_back(std::pair<int, int>((*it).tail, (*it).head));
+  }
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> vert(0, g.getNumVert() - 1);
+  int numHits = queries.size();
+  for (int i = 0; i < numHits; i++) {
+    queries.push_back(std::pair<int, int>(vert(rng), vert(rng)));
+  }
+  std::shuffle(queries.begin(), queries.end(), rng);
+
+  haruki::Graph indexed(g);
+  auto startBuild = hrk_clock::now();
+  indexed.buildEdgeIndex(loadFactor);
+  auto endBuild = hrk_clock::now();
+
+  double sum = 0;
+  auto startBinary = hrk_clock::now();
+  for (auto it = queries.begin(); it != queries.end(); ++it) {
+    sum += g.getEdgeCost(it->first, it->second);
+  }
+  auto endBinary = hrk_clock::now();
+
+  double sumIndexed = 0;
+  auto startIndexed = hrk_clock::now();
+  for (auto it = queries.begin(); it != queries.end(); ++it) {
+    sumIndexed += indexed.getEdgeCost(it->first, it->second);
+  }
+  auto endIndexed = hrk_clock::now();
+
+  if (sum != sumIndexed) {
+    std::cerr << "Edge index and binary search disagree" << std::endl;
+  }
+
+  std::cout << "LOOKUPS|" << queries.size() << "\n";
+  std::cout << "EDGE_INDEX_LOAD_FACTOR|" << loadFactor << "\n";
+  std::cout << "EDGE_INDEX_BUILD_MS|" << elapsedMs(startBuild, endBuild) << "\n";
+  std::cout << "EDGE_INDEX_BYTES_PER_EDGE|" << (double)indexed.edgeIndexBytes() / g.getNumEdges() << "\n";
+  std::cout << "BINARY_SEARCH_NS_PER_LOOKUP|" << elapsedMs(startBinary, endBinary) * 1e6 / queries.size() << "\n";
+  std::cout << "EDGE_INDEX_NS_PER_LOOKUP|" << elapsedMs(startIndexed, endIndexed) * 1e6 / queries.size() << "\n";
+}
+
+/*
+ * Parsing and CSR construction timed apart, the chunked parse and the
+ * construction once for each thread count from 1 up to maxThreads
+ * (doubling).
+ */
+static void benchLoad(std::string filepath, int maxThreads) {
+  haruki::GraphBuilder streamed;
+  auto startParse = hrk_clock::now();
+  if (!haruki::dimacs::readGrFile(filepath, streamed)) {
+    return;
+  }
+  auto endParse = hrk_clock::now();
+  haruki::GraphBuilder pg;
+  auto startMapped = hrk_clock::now();
+  haruki::dimacs::readGrFileMapped(filepath, pg, 1);
+  auto endMapped = hrk_clock::now();
+
+  std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+  double megabytes = file.tellg() / 1e6;
+  double parseMs = elapsedMs(startParse, endParse);
+  double mappedMs = elapsedMs(startMapped, endMapped);
+  std::cout << "VERTICES|" << pg.getNumVert() << "\n";
+  std::cout << "EDGES|" << pg.getEdges().size() << "\n";
+  std::cout << "PARSE_MS|" << parseMs << "\n";
+  std::cout << "PARSE_MB_S|" << megabytes / (parseMs / 1000) << "\n";
+  std::cout << "MAPPED_PARSE_MS|" << mappedMs << "\n";
+  std::cout << "MAPPED_PARSE_MB_S|" << megabytes / (mappedMs / 1000) << "\n";
+  std::cout << "MAPPED_SPEEDUP|" << parseMs / mappedMs << "\n";
+  if (streamed.getEdges().size() != pg.getEdges().size()) {
+    std::cout << "MAPPED_EDGES_MISMATCH|" << streamed.getEdges().size() << "\n";
+  }
+  streamed = haruki::GraphBuilder();
+
+  for (int numThreads = 2; numThreads <= maxThreads; numThreads *= 2) {
+    haruki::GraphBuilder chunked;
+    auto startChunked = hrk_clock::now();
+    haruki::dimacs::readGrFileMapped(filepath, chunked, numThreads);
+    auto endChunked = hrk_clock::now();
+    double chunkedMs = elapsedMs(startChunked, endChunked);
+    std::cout << "MAPPED_PARSE_MS_" << numThreads << "_THREADS|" << chunkedMs << "\n";
+    std::cout << "MAPPED_PARSE_MB_S_" << numThreads << "_THREADS|" << megabytes / (chunkedMs / 1000) << "\n";
+    if (chunked.getEdges().size() != pg.getEdges().size()) {
+      std::cout << "CHUNKED_EDGES_MISMATCH_" << numThreads << "_THREADS|" << chunked.getEdges().size() << "\n";
+    }
+  }
+
+  for (int numThreads = 1;; numThreads *= 2) {
+    if (numThreads > maxThreads) {
+      numThreads = maxThreads;
+    }
+    auto startBuild = hrk_clock::now();
+    haruki::Graph g(pg, numThreads);
+    auto endBuild = hrk_clock::now();
+    std::cout << "BUILD_MS_" << numThreads << "_THREADS|" << elapsedMs(startBuild, endBuild) << "\n";
+    if (numThreads == maxThreads) {
+      break;
+    }
+  }
+}
+
+/*
+ * Time and peak memory of a single load, through the GraphBuilder
+ * ("mapped") or straight into the CSR arrays ("direct"), or of a snapshot
+ * when given one. Meant to be run
+ * in a fresh process: the peak is the process' high-water mark.
+ */
+static void benchLoadMemory(std::string filepath, std::string loader) {
+  auto startLoad = hrk_clock::now();
+  haruki::Graph *g;
+  if (haruki::snapshot::isSnapshot(filepath)) {
+    g = haruki::snapshot::load(filepath);
+  } else if (loader == "direct") {
+    g = haruki::dimacs::readGrFileDirect(filepath);
+  } else {
+    g = haruki::dimacs::readGrFileMapped(filepath);
+  }
+  auto endLoad = hrk_clock::now();
+  if (g == nullptr) {
+    return;
+  }
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  std::cout << "VERTICES|" << g->getNumVert() << "\n";
+  std::cout << "EDGES|" << g->getNumEdges() << "\n";
+  std::cout << "LOAD_MS|" << elapsedMs(startLoad, endLoad) << "\n";
+  std::cout << "GRAPH_MB|" << g->topologyBytes() / 1e6 << "\n";
+  /* ru_maxrss is in kilobytes on Linux */
+  std::cout << "PEAK_RSS_MB|" << usage.ru_maxrss / 1e3 << "\n";
+  delete g;
+}
+
+/*
+ * Memory taken by the topology, plain and compressed, and the time per
+ * relaxed edge of full sweeps over the outgoing edges and of Dijkstra runs
+ * from random sources on each of them.
+ */
+static void benchCompressed(haruki::Graph &g, int numSources) {
+  haruki::Graph packed(g.getTopology());
+  packed.compress();
+
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> vert(0, g.getNumVert() - 1);
+  std::vector<int> sources;
+  for (int i = 0; i < numSources; i++) {
+    sources.push_back(vert(rng));
+  }
+
+  haruki::Graph *graphs[] = {&g, &packed};
+  const char *names[] = {"PLAIN", "COMPRESSED"};
+  double sweepNs[2];
+  double dijkstraNs[2];
+  for (int i = 0; i < 2; i++) {
+    haruki::Graph &h = *graphs[i];
+    double sum = 0;
+    auto startSweep = hrk_clock::now();
+    for (int r = 0; r < numSources; r++) {
+      for (int v = 0; v < h.getNumVert(); v++) {
+        haruki::EdgeOut::range edges = h.getEdgesOut(v);
+        for (haruki::EdgeOut::iterator it = edges.begin(); it != edges.end(); ++it) {
+          sum += it.head() + it.cost();
+        }
+      }
+    }
+    auto endSweep = hrk_clock::now();
+    sweepNs[i] = elapsedMs(startSweep, endSweep) * 1e6 / ((double)numSources * h.getNumEdges());
+
+    auto startDijkstra = hrk_clock::now();
+    for (auto it = sources.begin(); it != sources.end(); ++it) {
+      haruki::HugeVector<int> parents;
+      haruki::HugeVector<haruki::Weight> distances;
+      haruki::dijkstra::dijkstra_parents(h, *it, -1, false, parents, distances);
+    }
+    auto endDijkstra = hrk_clock::now();
+    dijkstraNs[i] = elapsedMs(startDijkstra, endDijkstra) * 1e6 / ((double)numSources * h.getNumEdges());
+
+    std::cout << names[i] << "_BYTES_PER_EDGE|" << (double)h.topologyBytes() / h.getNumEdges() << "\n";
+    std::cout << names[i] << "_SWEEP_NS_PER_EDGE|" << sweepNs[i] << "\n";
+    std::cout << names[i] << "_DIJKSTRA_NS_PER_EDGE|" << dijkstraNs[i] << "\n";
+    if (sum < 0) {
+      std::cout << sum << "\n";
+    }
+  }
+  std::cout << "SWEEP_SLOWDOWN|" << sweepNs[1] / sweepNs[0] << "\n";
+  std::cout << "DIJKSTRA_SLOWDOWN|" << dijkstraNs[1] / dijkstraNs[0] << "\n";
+}
+
+/*
+ * Throughput of updateEdgeCosts() with batches of random existing edges,
+ * through binary search and through the edge index, and the cost of the
+ * first batch applied while a copy of the graph shares its topology.
+ */
+static void benchUpdates(haruki::Graph &g, int batchSize) {
+  std::vector<haruki::EdgeInfo> edges = g.getEdgeInfoList();
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<size_t> pick(0, edges.size() - 1);
+  std::uniform_int_distribution<int> cost(1, 1000);
+  int numBatches = std::max(1, (int)(4 * edges.size() / batchSize));
+  std::vector<std::vector<haruki::EdgeInfo> > batches(numBatches);
+  for (int b = 0; b < numBatches; b++) {
+    for (int i = 0; i < batchSize; i++) {
+      const haruki::EdgeInfo &ei = edges[pick(rng)];
+      batches[b].push_back(haruki::EdgeInfo(ei.tail, ei.head, cost(rng)));
+    }
+  }
+
+  {
+    haruki::Graph snapshot(g);
+    auto startShared = hrk_clock::now();
+    g.updateEdgeCosts(batches[0]);
+    auto endShared = hrk_clock::now();
+    std::cout << "UPDATE_SHARED_TOPOLOGY_MS|" << elapsedMs(startShared, endShared) << "\n";
+  }
+
+  const char *names[] = {"BINARY_SEARCH", "EDGE_INDEX"};
+  for (int i = 0; i < 2; i++) {
+    if (i == 1) {
+      g.buildEdgeIndex();
+    }
+    long long applied = 0;
+    auto start = hrk_clock::now();
+    for (int b = 0; b < numBatches; b++) {
+      applied += g.updateEdgeCosts(batches[b]);
+    }
+    auto end = hrk_clock::now();
+    if (applied != (long long)numBatches * batchSize) {
+      std::cerr << "Some updates were not applied" << std::endl;
+    }
+    std::cout << names[i] << "_UPDATE_EDGES_PER_S|" << applied / (elapsedMs(start, end) / 1000) << "\n";
+    g.clearDirtyEdges();
+  }
+  std::cout << "BATCH_SIZE|" << batchSize << "\n";
+  std::cout << "COST_VERSION|" << g.getCostVersion() << "\n";
+}
+
+static double dijkstraNsPerEdge(haruki::Graph &g, const std::vector<int> &sources) {
+  auto start = hrk_clock::now();
+  for (auto it = sources.begin(); it != sources.end(); ++it) {
+    haruki::HugeVector<int> parents;
+    haruki::HugeVector<haruki::Weight> distances;
+    haruki::dijkstra::dijkstra_parents(g, *it, -1, false, parents, distances);
+  }
+  auto end = hrk_clock::now();
+  return elapsedMs(start, end) * 1e6 / ((double)sources.size() * g.getNumEdges());
+}
+
+/*
+ * Insertion and deletion throughput of the delta overlay when it reaches
+ * fraction of the edges (half inserted, half deleted), the Dijkstra
+ * slowdown it causes, and the time to fold it back into a CSR.
+ */
+static void benchDelta(haruki::Graph &g, double fraction) {
+  std::vector<haruki::EdgeInfo> edges = g.getEdgeInfoList();
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<size_t> pick(0, edges.size() - 1);
+  std::uniform_int_distribution<int> vert(0, g.getNumVert() - 1);
+  std::uniform_int_distribution<int> cost(1, 1000);
+  size_t numChanges = std::max<size_t>(1, fraction * edges.size() / 2);
+  std::vector<haruki::EdgeInfo> inserted, deleted;
+  for (size_t i = 0; i < numChanges; i++) {
+    /* mostly parallel to existing edges, a few long range ones */
+    const haruki::EdgeInfo &ei = edges[pick(rng)];
+    inserted.push_back(haruki::EdgeInfo(ei.tail, vert(rng) % 64 == 0 ? vert(rng) : ei.head, cost(rng)));
+    deleted.push_back(edges[pick(rng)]);
+  }
+  std::vector<int> sources;
+  for (int i = 0; i < 5; i++) {
+    sources.push_back(vert(rng));
+  }
+
+  double baseNs = dijkstraNsPerEdge(g, sources);
+
+  auto startInsert = hrk_clock::now();
+  g.insertEdges(inserted);
+  auto endInsert = hrk_clock::now();
+  auto startDelete = hrk_clock::now();
+  haruki::EdgeIdx numDeleted = g.deleteEdges(deleted);
+  auto endDelete = hrk_clock::now();
+  double deltaNs = dijkstraNsPerEdge(g, sources);
+
+  std::cout << "DELTA_SIZE|" << g.getDeltaSize() << "\n";
+  std::cout << "DELTA_BYTES|" << g.deltaBytes() << "\n";
+  std::cout << "INSERT_EDGES_PER_S|" << inserted.size() / (elapsedMs(startInsert, endInsert) / 1000) << "\n";
+  std::cout << "DELETE_EDGES_PER_S|" << numDeleted / (elapsedMs(startDelete, endDelete) / 1000) << "\n";
+  std::cout << "CSR_DIJKSTRA_NS_PER_EDGE|" << baseNs << "\n";
+  std::cout << "DELTA_DIJKSTRA_NS_PER_EDGE|" << deltaNs << "\n";
+
+  auto startCompact = hrk_clock::now();
+  g.compactDelta();
+  auto endCompact = hrk_clock::now();
+  double compactedNs = dijkstraNsPerEdge(g, sources);
+  std::cout << "COMPACT_MS|" << elapsedMs(startCompact, endCompact) << "\n";
+  std::cout << "COMPACTED_DIJKSTRA_NS_PER_EDGE|" << compactedNs << "\n";
+  std::cout << "DELTA_SLOWDOWN|" << deltaNs / compactedNs << "\n";
+}
+
+/* data TLB load misses of this process, if the kernel lets us count them */
+class DtlbMissCounter {
+  int fd_ = -1;
+
+public:
+  DtlbMissCounter() {
+#ifdef __linux__
+    struct perf_event_attr pe;
+    memset(&pe, 0, sizeof(pe));
+    pe.type = PERF_TYPE_HW_CACHE;
+    pe.size = sizeof(pe);
+    pe.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    pe.disabled = 1;
+    pe.exclude_kernel = 1;
+    pe.exclude_hv = 1;
+    fd_ = syscall(__NR_perf_event_open, &pe, 0, -1, -1, 0);
+#endif
+  }
+  ~DtlbMissCounter() {
+#ifdef __linux__
+    if (fd_ != -1) {
+      close(fd_);
+    }
+#endif
+  }
+
+  bool available() const { return fd_ != -1; }
+
+  void start() {
+#ifdef __linux__
+    if (fd_ != -1) {
+      ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+  }
+
+  long long stop() {
+    long long count = -1;
+#ifdef __linux__
+    if (fd_ != -1) {
+      ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+      if (read(fd_, &count, sizeof(count)) != sizeof(count)) {
+        count = -1;
+      }
+    }
+#endif
+    return count;
+  }
+};
+
+/* anonymous memory of this process backed by transparent huge pages */
+static long long anonHugePagesKb() {
+  std::ifstream smaps("/proc/self/smaps_rollup");
+  std::string line;
+  while (std::getline(smaps, line)) {
+    if (line.compare(0, 14, "AnonHugePages:") == 0) {
+      std::stringstream ss(line.substr(14));
+      long long kb = 0;
+      ss >> kb;
+      return kb;
+    }
+  }
+  return -1;
+}
+
+/*
+ * Dijkstra from random sources on copies of the graph whose arrays were
+ * allocated under each huge page mode: wall time and data TLB misses per
+ * edge, and how much memory the kernel actually backed with huge pages.
+ */
+static void benchHugePages(haruki::Graph &g, int numSources) {
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> vert(0, g.getNumVert() - 1);
+  std::vector<int> sources;
+  for (int i = 0; i < numSources; i++) {
+    sources.push_back(vert(rng));
+  }
+  haruki::GraphBuilder pg;
+  pg.setNumVert(g.getNumVert());
+  std::vector<haruki::EdgeInfo> edges = g.getEdgeInfoList();
+  for (auto it = edges.begin(); it != edges.end(); ++it) {
+    pg.addEdge(*it);
+  }
+  edges = std::vector<haruki::EdgeInfo>();
+
+  DtlbMissCounter counter;
+  if (!counter.available()) {
+    std::cout << "DTLB_COUNTER|unavailable\n";
+  }
+  const char *modes[] = {"off", "system", "thp", "hugetlb"};
+  for (int m = 0; m < 4; m++) {
+    haruki::hugepage::Mode mode;
+    haruki::hugepage::parseMode(modes[m], mode);
+    haruki::hugepage::setMode(mode);
+    long long hugeKbBefore = anonHugePagesKb();
+    haruki::Graph h(pg);
+    haruki::HugeVector<int> parents;
+    haruki::HugeVector<haruki::Weight> distances;
+    /* allocates the search arrays under the mode too */
+    haruki::dijkstra::dijkstra_parents(h, sources[0], -1, false, parents, distances);
+    long long hugeKb = anonHugePagesKb() - hugeKbBefore;
+
+    counter.start();
+    auto start = hrk_clock::now();
+    for (auto it = sources.begin(); it != sources.end(); ++it) {
+      parents.assign(parents.size(), -1);
+      distances.assign(distances.size(), -1);
+      haruki::dijkstra::dijkstra_parents(h, *it, -1, false, parents, distances);
+    }
+    auto end = hrk_clock::now();
+    long long misses = counter.stop();
+    double perEdge = (double)numSources * h.getNumEdges();
+
+    std::string name(modes[m]);
+    std::transform(name.begin(), name.end(), name.begin(), ::toupper);
+    std::cout << name << "_DIJKSTRA_NS_PER_EDGE|" << elapsedMs(start, end) * 1e6 / perEdge << "\n";
+    if (misses >= 0) {
+      std::cout << name << "_DTLB_MISSES_PER_EDGE|" << misses / perEdge << "\n";
+    }
+    std::cout << name << "_ANON_HUGE_KB|" << hugeKb << "\n";
+  }
+  haruki::hugepage::setMode(haruki::hugepage::SYSTEM);
+}
+
+/*
+ * Saves g as a snapshot and loads it back, against the time the text file
+ * took to load; the snapshot has to give the same edges.
+ */
+static void benchSnapshot(haruki::Graph &g, double loadMs, std::string snapshotPath) {
+  auto startSave = hrk_clock::now();
+  if (!haruki::snapshot::save(g, snapshotPath)) {
+    return;
+  }
+  auto endSave = hrk_clock::now();
+  haruki::Graph *loaded = haruki::snapshot::load(snapshotPath);
+  auto endLoad = hrk_clock::now();
+  if (loaded == nullptr) {
+    return;
+  }
+
+  std::ifstream file(snapshotPath, std::ios::binary | std::ios::ate);
+  double snapshotMs = elapsedMs(endSave, endLoad);
+  std::cout << "SNAPSHOT_MB|" << file.tellg() / 1e6 << "\n";
+  std::cout << "SAVE_MS|" << elapsedMs(startSave, endSave) << "\n";
+  std::cout << "SNAPSHOT_LOAD_MS|" << snapshotMs << "\n";
+  std::cout << "SNAPSHOT_SPEEDUP|" << loadMs / snapshotMs << "\n";
+
+  std::vector<haruki::EdgeInfo> expected = g.getEdgeInfoList();
+  std::vector<haruki::EdgeInfo> actual = loaded->getEdgeInfoList();
+  bool same = expected.size() == actual.size();
+  for (size_t i = 0; same && i < expected.size(); i++) {
+    same = expected[i].tail == actual[i].tail && expected[i].head == actual[i].head && expected[i].cost == actual[i].cost;
+  }
+  if (!same) {
+    std::cout << "SNAPSHOT_MISMATCH|1\n";
+  }
+  delete loaded;
+}
+
+/*
+ * Memory of the topology with its reverse index and with symmetric storage,
+ * and the time of reverse Dijkstra searches, which walk incoming edges.
+ */
+static void benchSymmetric(haruki::Graph &g, int numSources) {
+  haruki::Graph sym(g.getTopology());
+  if (!sym.useSymmetricStorage()) {
+    std::cout << "SYMMETRIC|0\n";
+    return;
+  }
+  std::cout << "SYMMETRIC|1\n";
+  g.buildReverseIndex();
+
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> vert(0, g.getNumVert() - 1);
+  std::vector<int> sources;
+  for (int i = 0; i < numSources; i++) {
+    sources.push_back(vert(rng));
+  }
+
+  haruki::Graph *graphs[] = {&g, &sym};
+  const char *names[] = {"PLAIN", "SYMMETRIC"};
+  size_t bytes[2];
+  for (int i = 0; i < 2; i++) {
+    haruki::Graph &h = *graphs[i];
+    auto start = hrk_clock::now();
+    for (auto it = sources.begin(); it != sources.end(); ++it) {
+      haruki::HugeVector<int> parents;
+      haruki::HugeVector<haruki::Weight> distances;
+      haruki::dijkstra::dijkstra_parents_reverse(h, *it, -1, false, parents, distances);
+    }
+    auto end = hrk_clock::now();
+    bytes[i] = h.topologyBytes();
+    std::cout << names[i] << "_BYTES|" << bytes[i] << "\n";
+    std::cout << names[i] << "_REVERSE_DIJKSTRA_MS|" << elapsedMs(start, end) / numSources << "\n";
+  }
+  std::cout << "BYTES_RATIO|" << (double)bytes[1] / bytes[0] << "\n";
+}
+
+/* Yen's k shortest paths from s to t, with KSP::run's timings kept quiet */
+static std::vector<haruki::Path> quietYen(haruki::Graph &g, int s, int t, int k) {
+  haruki::KSP<haruki::YenKSP> yen;
+  std::streambuf *out = std::cout.rdbuf(nullptr);
+  std::vector<haruki::Path> paths = yen.run(g, s, t, k);
+  std::cout.rdbuf(out);
+  std::cout.clear();
+  return paths;
+}
+
+/*
+ * Yen on random s-t pairs, on the graph and on its chain contraction for
+ * that pair (contraction time included). Paths of equal cost may come in
+ * another order, so only the costs are compared.
+ */
+static void benchContract(haruki::Graph &g, int k, int numQueries) {
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> vert(0, g.getNumVert() - 1);
+  double plainMs = 0, contractMs = 0, contractedMs = 0;
+  double vertRatio = 0, edgeRatio = 0;
+  int mismatches = 0;
+  for (int q = 0; q < numQueries; q++) {
+    int s = vert(rng), t = vert(rng);
+
+    auto startPlain = hrk_clock::now();
+    std::vector<haruki::Path> expected = quietYen(g, s, t, k);
+    auto endPlain = hrk_clock::now();
+    haruki::Graph *contracted = haruki::contract::contractChains(g, s, t);
+    auto endContract = hrk_clock::now();
+    std::vector<haruki::Path> result = quietYen(*contracted, s, t, k);
+    auto endContracted = hrk_clock::now();
+
+    plainMs += elapsedMs(startPlain, endPlain);
+    contractMs += elapsedMs(endPlain, endContract);
+    contractedMs += elapsedMs(endContract, endContracted);
+    vertRatio += (double)contracted->getNumVert() / g.getNumVert();
+    edgeRatio += (double)contracted->getNumEdges() / g.getNumEdges();
+    bool same = expected.size() == result.size();
+    for (size_t i = 0; same && i < expected.size(); i++) {
+      same = expected[i].cost() == result[i].cost();
+    }
+    mismatches += !same;
+    delete contracted;
+  }
+  std::cout << "CONTRACTED_VERTICES_RATIO|" << vertRatio / numQueries << "\n";
+  std::cout << "CONTRACTED_EDGES_RATIO|" << edgeRatio / numQueries << "\n";
+  std::cout << "CONTRACT_MS|" << contractMs / numQueries << "\n";
+  std::cout << "PLAIN_KSP_MS|" << plainMs / numQueries << "\n";
+  std::cout << "CONTRACTED_KSP_MS|" << contractedMs / numQueries << "\n";
+  std::cout << "SPEEDUP|" << plainMs / (contractMs + contractedMs) << "\n";
+  std::cout << "MISMATCHES|" << mismatches << "\n";
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 3) {
+    std::cout << " Usage: " << argv[0] << " <benchmark> <input_file> [args]" << std::endl;
+    std::cout << " Benchmarks:" << std::endl;
+    std::cout << "   edgeindex <input_file> [load_factor]" << std::endl;
+    std::cout << "   load <input_file> [max_threads]" << std::endl;
+    std::cout << "   loadmemory <input_file> [mapped|direct]" << std::endl;
+    std::cout << "   compressed <input_file> [sources]" << std::endl;
+    std::cout << "   updates <input_file> [batch_size]" << std::endl;
+    std::cout << "   delta <input_file> [fraction]" << std::endl;
+    std::cout << "   hugepages <input_file> [sources]" << std::endl;
+    std::cout << "   contract <input_file> [k] [queries]" << std::endl;
+    std::cout << "   symmetric <input_file> [sources]" << std::endl;
+    std::cout << "   snapshot <input_file> [snapshot_file]" << std::endl;
+    exit(0);
+  }
+
+  std::string benchmark = std::string(argv[1]);
+
+  if (benchmark == "load") {
+    int maxThreads = haruki::defaultNumThreads();
+    if (argc > 3) {
+      std::stringstream ss(argv[3]);
+      if (!(ss >> maxThreads) || maxThreads < 1) {
+        std::cerr << "Invalid number of threads " << argv[3] << std::endl;
+        maxThreads = 1;
+      }
+    }
+    benchLoad(std::string(argv[2]), maxThreads);
+    return 0;
+  }
+  if (benchmark == "loadmemory") {
+    benchLoadMemory(std::string(argv[2]), argc > 3 ? std::string(argv[3]) : "direct");
+    return 0;
+  }
+
+  auto startLoad = hrk_clock::now();
+  haruki::Graph *g = (haruki::snapshot::isSnapshot(std::string(argv[2]))
+                          ? haruki::snapshot::load(std::string(argv[2]))
+                          : haruki::dimacs::readGrFileDirect(std::string(argv[2])));
+  auto endLoad = hrk_clock::now();
+  if (g == nullptr) {
+    return 0;
+  }
+  std::cout << "VERTICES|" << g->getNumVert() << "\n";
+  std::cout << "EDGES|" << g->getNumEdges() << "\n";
+  std::cout << "LOAD_MS|" << elapsedMs(startLoad, endLoad) << "\n";
+
+  if (benchmark == "edgeindex") {
+    double loadFactor = 0.5;
+    if (argc > 3) {
+      std::stringstream ss(argv[3]);
+      if (!(ss >> loadFactor) || !haruki::EdgeIndex::isValidLoadFactor(loadFactor)) {
+        std::cerr << "Invalid load factor " << argv[3] << ", must be in (0, 1)" << std::endl;
+        loadFactor = 0.5;
+      }
+    }
+    benchEdgeIndex(*g, loadFactor);
+  } else if (benchmark == "compressed") {
+    int numSources = 5;
+    if (argc > 3) {
+      std::stringstream ss(argv[3]);
+      if (!(ss >> numSources) || numSources < 1) {
+        std::cerr << "Invalid number of sources " << argv[3] << std::endl;
+        numSources = 5;
+      }
+    }
+    benchCompressed(*g, numSources);
+  } else if (benchmark == "updates") {
+    int batchSize = 10000;
+    if (argc > 3) {
+      std::stringstream ss(argv[3]);
+      if (!(ss >> batchSize) || batchSize < 1) {
+        std::cerr << "Invalid batch size " << argv[3] << std::endl;
+        batchSize = 10000;
+      }
+    }
+    benchUpdates(*g, batchSize);
+  } else if (benchmark == "delta") {
+    double fraction = 0.05;
+    if (argc > 3) {
+      std::stringstream ss(argv[3]);
+      if (!(ss >> fraction) || fraction <= 0) {
+        std::cerr << "Invalid fraction " << argv[3] << std::endl;
+        fraction = 0.05;
+      }
+    }
+    benchDelta(*g, fraction);
+  } else if (benchmark == "hugepages") {
+    int numSources = 5;
+    if (argc > 3) {
+      std::stringstream ss(argv[3]);
+      if (!(ss >> numSources) || numSources < 1) {
+        std::cerr << "Invalid number of sources " << argv[3] << std::endl;
+        numSources = 5;
+      }
+    }
+    benchHugePages(*g, numSources);
+  } else if (benchmark == "contract") {
+    int k = 10;
+    int numQueries = 5;
+    if (argc > 3) {
+      std::stringstream ss(argv[3]);
+      if (!(ss >> k) || k < 1) {
+        std::cerr << "Invalid number of paths " << argv[3] << std::endl;
+        k = 10;
+      }
+    }
+    if (argc > 4) {
+      std::stringstream ss(argv[4]);
+      if (!(ss >> numQueries) || numQueries < 1) {
+        std::cerr << "Invalid number of queries " << argv[4] << std::endl;
+        numQueries = 5;
+      }
+    }
+    benchContract(*g, k, numQueries);
+  } else if (benchmark == "symmetric") {
+    int numSources = 5;
+    if (argc > 3) {
+      std::stringstream ss(argv[3]);
+      if (!(ss >> numSources) || numSources < 1) {
+        std::cerr << "Invalid number of sources " << argv[3] << std::endl;
+        numSources = 5;
+      }
+    }
+    benchSymmetric(*g, numSources);
+  } else if (benchmark == "snapshot") {
+    std::string snapshotPath = (argc > 3 ? std::string(argv[3]) : std::string(argv[2]) + ".snapshot");
+    benchSnapshot(*g, elapsedMs(startLoad, endLoad), snapshotPath);
+  } else {
+    std::cerr << "Unknown benchmark " << benchmark << std::endl;
+  }
+
+  delete g;
+}
@@ -23,6 +23,11 @@
 #include <sstream>
 #include "graph.hpp"
 #include "dimacsreader.hpp"
+#include "reorder.hpp"
+#include "trim.hpp"
+#include "contract.hpp"
+#include "hugepage.hpp"
+#include "snapshot.hpp"
 #include "yenksp.hpp"
 #include "pascoalksp.hpp"
 #include "fengksp.hpp"
@@ -48,8 +53,18 @@ std::vector<int> hrk_feng_yellow_path_list;
 #endif
 
 int main(int argc, char* argv[]) {
-  if (argc != 6) {
-    std::cout << " Usage: " << argv[0] << "<algorithm> <input_file> <s> <t> <k>" << std::endl;
+  if (argc < 6) {
+    std::cout << " Usage: " << argv[0] << "<algorithm> <input_file> <s> <t> <k> [options]" << std::endl;
+    std::cout << " input_file is a DIMACS .gr file or a snapshot saved by ksp-snapshot" << std::endl;
+    std::cout << " Options:" << std::endl;
+    std::cout << "   --repeated=<all|first|min>    arcs repeating a (u, v) pair: keep all, the first (default) or the cheapest" << std::endl;
+    std::cout << "   --edge-index[=<load_factor>]  hash (tail, head) lookups instead of binary search, load factor in (0, 1)" << std::endl;
+    std::cout << "   --reorder=<bfs|rcm|degree>    renumber vertices for locality, paths keep the input ids" << std::endl;
+    std::cout << "   --trim[=<stretch>]            run on the s-t core only, within stretch * d(s, t) if given" << std::endl;
+    std::cout << "   --contract                    replace chains of degree-2 vertices by single edges" << std::endl;
+    std::cout << "   --symmetric                   serve incoming edges from the outgoing ones if every edge has a twin" << std::endl;
+    std::cout << "   --compress                    keep the adjacency varint coded and costs dictionary coded" << std::endl;
+    std::cout << "   --huge-pages=<off|system|thp|hugetlb>  page size for the graph and search arrays" << std::endl;
     exit(0);
   }
 
@@ -80,11 +95,100 @@ int main(int argc, char* argv[]) {
       std::cerr << "Invalid number of paths to find " << argv[4] << std::endl;
   }
 
-  haruki::Graph *g = haruki::dimacs::readGrFile(std::string(argv[2]));
+  double edgeIndexLoadFactor = 0;
+  haruki::reorder::Strategy vertexOrder = haruki::reorder::NONE;
+  bool compress = false;
+  bool trim = false;
+  double trimStretch = 0;
+  bool contract = false;
+  bool symmetric = false;
+  haruki::RepeatedEdges repeated = haruki::KEEP_FIRST_REPEATED;
+  for (int i = 6; i < argc; i++) {
+    std::string option = std::string(argv[i]);
+    std::string value;
+    size_t eq = option.find('=');
+    if (eq != std::string::npos) {
+      value = option.substr(eq + 1);
+      option = option.substr(0, eq);
+    }
+
+    if (option == "--repeated") {
+      if (!haruki::dimacs::parseRepeatedEdges(value, repeated)) {
+        std::cerr << "Invalid repeated arc policy " << value << std::endl;
+      }
+    } else if (option == "--edge-index") {
+      edgeIndexLoadFactor = 0.5;
+      std::stringstream ss(value);
+      if (!value.empty() && (!(ss >> edgeIndexLoadFactor) || !haruki::EdgeIndex::isValidLoadFactor(edgeIndexLoadFactor))) {
+        std::cerr << "Invalid load factor " << value << ", must be in (0, 1)" << std::endl;
+        edgeIndexLoadFactor = 0.5;
+      }
+    } else if (option == "--reorder") {
+      if (!haruki::reorder::parseStrategy(value, vertexOrder)) {
+        std::cerr << "Invalid vertex order " << value << std::endl;
+      }
+    } else if (option == "--trim") {
+      trim = true;
+      std::stringstream ss(value);
+      if (!value.empty() && !(ss >> trimStretch)) {
+        std::cerr << "Invalid stretch " << value << std::endl;
+        trimStretch = 0;
+      }
+    } else if (option == "--contract") {
+      contract = true;
+    } else if (option == "--symmetric") {
+      symmetric = true;
+    } else if (option == "--compress") {
+      compress = true;
+    } else if (option == "--huge-pages") {
+      haruki::hugepage::Mode mode;
+      if (haruki::hugepage::parseMode(value, mode)) {
+        haruki::hugepage::setMode(mode);
+      } else {
+        std::cerr << "Invalid huge page mode " << value << std::endl;
+      }
+    } else {
+      std::cerr << "Unknown option " << argv[i] << std::endl;
+    }
+  }
+
+  /* after the options, so that the graph is allocated with their mode */
+  haruki::Graph *g = (haruki::snapshot::isSnapshot(std::string(argv[2]))
+                          ? haruki::snapshot::load(std::string(argv[2]))
+                          : haruki::dimacs::readGrFileDirect(std::string(argv[2]), 0, repeated));
   if (g == nullptr) {
     return 0;
   }
 
+  if (vertexOrder != haruki::reorder::NONE) {
+    haruki::Graph *reordered = haruki::reorder::reorderGraph(*g, vertexOrder);
+    delete g;
+    g = reordered;
+  }
+  if (trim) {
+    haruki::Graph *trimmed = haruki::trim::trimToCore(*g, g->toInternalId(s), g->toInternalId(t), trimStretch);
+    std::cout << "TRIM|" << g->getNumVert() << "|" << g->getNumEdges() << "|"
+              << trimmed->getNumVert() << "|" << trimmed->getNumEdges() << "\n";
+    delete g;
+    g = trimmed;
+  }
+  if (contract) {
+    haruki::Graph *contracted = haruki::contract::contractChains(*g, g->toInternalId(s), g->toInternalId(t));
+    std::cout << "CONTRACT|" << g->getNumVert() << "|" << g->getNumEdges() << "|"
+              << contracted->getNumVert() << "|" << contracted->getNumEdges() << "\n";
+    delete g;
+    g = contracted;
+  }
+  if (symmetric && !g->useSymmetricStorage()) {
+    std::cerr << "Graph is not symmetric, keeping the reverse index" << std::endl;
+  }
+  if (compress) {
+    g->compress();
+  }
+  if (edgeIndexLoadFactor > 0) {
+    g->buildEdgeIndex(edgeIndexLoadFactor);
+  }
+
   std::string algorithm = std::string(argv[1]);
 
   if (algorithm == "yen") {
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2018 Diogo Haruki Kykuta
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+*/
+#include <iostream>
+#include <string>
+#include "graph.hpp"
+#include "dimacsreader.hpp"
+#include "reorder.hpp"
+#include "snapshot.hpp"
+
+/*
+ * Parses a DIMACS file once and saves the finished graph as a snapshot,
+ * which ksp-single-algorithm and ksp-benchmark then load in place of the
+ * text file.
+ */
+int main(int argc, char* argv[]) {
+  if (argc < 3) {
+    std::cout << " Usage: " << argv[0] << " <input_file> <snapshot_file> [options]" << std::endl;
+    std::cout << " Options:" << std::endl;
+    std::cout << "   --repeated=<all|first|min>    arcs repeating a (u, v) pair: keep all, the first (default) or the cheapest" << std::endl;
+    std::cout << "   --reorder=<bfs|rcm|degree>    renumber vertices for locality, the snapshot keeps the input ids" << std::endl;
+    std::cout << "   --symmetric                   leave the reverse index out if every edge has a twin" << std::endl;
+    exit(0);
+  }
+
+  haruki::RepeatedEdges repeated = haruki::KEEP_FIRST_REPEATED;
+  haruki::reorder::Strategy vertexOrder = haruki::reorder::NONE;
+  bool symmetric = false;
+  for (int i = 3; i < argc; i++) {
+    std::string option = std::string(argv[i]);
+    std::string value;
+    size_t eq = option.find('=');
+    if (eq != std::string::npos) {
+      value = option.substr(eq + 1);
+      option = option.substr(0, eq);
+    }
+
+    if (option == "--repeated") {
+      if (!haruki::dimacs::parseRepeatedEdges(value, repeated)) {
+        std::cerr << "Invalid repeated arc policy " << value << std::endl;
+      }
+    } else if (option == "--reorder") {
+      if (!haruki::reorder::parseStrategy(value, vertexOrder)) {
+        std::cerr << "Invalid vertex order " << value << std::endl;
+      }
+    } else if (option == "--symmetric") {
+      symmetric = true;
+    } else {
+      std::cerr << "Unknown option " << argv[i] << std::endl;
+    }
+  }
+
+  haruki::Graph *g = haruki::dimacs::readGrFileDirect(std::string(argv[1]), 0, repeated);
+  if (g == nullptr) {
+    return 1;
+  }
+  if (vertexOrder != haruki::reorder::NONE) {
+    haruki::Graph *reordered = haruki::reorder::reorderGraph(*g, vertexOrder);
+    delete g;
+    g = reordered;
+  }
+  if (symmetric && !g->useSymmetricStorage()) {
+    std::cerr << "Graph is not symmetric, keeping the reverse index" << std::endl;
+  }
+
+  bool saved = haruki::snapshot::save(*g, std::string(argv[2]));
+  if (saved) {
+    std::cout << "VERTICES|" << g->getNumVert() << "\n";
+    std::cout << "EDGES|" << g->getNumEdges() << "\n";
+  }
+  delete g;
+  return saved ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2018 Diogo Haruki Kykuta
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+*/
+#include "mappedfile.hpp"
+#include <fstream>
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace haruki
+{
+
+bool MappedFile::open(const std::string &filepath, bool sequential)
+{
+  close();
+#ifdef __linux__
+  int fd = ::open(filepath.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0)
+  {
+    ::close(fd);
+    return false;
+  }
+  size_ = st.st_size;
+  if (size_ == 0)
+  {
+    ::close(fd);
+    data_ = "";
+    return true;
+  }
+  void *p = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (p != MAP_FAILED)
+  {
+    if (sequential)
+    {
+      madvise(p, size_, MADV_SEQUENTIAL);
+    }
+    data_ = static_cast<const char *>(p);
+    mapped_ = true;
+    return true;
+  }
+  size_ = 0;
+#endif
+  /* no mmap: read the whole file instead */
+  std::ifstream in(filepath, std::ios::binary | std::ios::ate);
+  if (!in.is_open())
+  {
+    return false;
+  }
+  buffer_.resize(in.tellg());
+  in.seekg(0);
+  in.read(buffer_.data(), buffer_.size());
+  data_ = buffer_.data();
+  size_ = buffer_.size();
+  return true;
+}
+
+void MappedFile::close()
+{
+#ifdef __linux__
+  if (mapped_)
+  {
+    munmap(const_cast<char *>(data_), size_);
+  }
+#endif
+  buffer_ = std::vector<char>();
+  data_ = nullptr;
+  size_ = 0;
+  mapped_ = false;
+}
+
+}
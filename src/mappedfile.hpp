@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2018 Diogo Haruki Kykuta
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace haruki
+{
+
+/*
+ * Read-only view of a whole file, mapped in memory where mmap is available
+ * and read into a buffer elsewhere. The view lasts as long as the object.
+ */
+class MappedFile
+{
+private:
+  const char *data_;
+  size_t size_;
+  bool mapped_;
+  std::vector<char> buffer_;
+
+public:
+  MappedFile() : data_(nullptr), size_(0), mapped_(false) {}
+  ~MappedFile() { close(); }
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  /* sequential tells the kernel the file will be read from start to end */
+  bool open(const std::string &filepath, bool sequential = true);
+  void close();
+
+  const char *data() const { return data_; }
+  size_t size() const { return size_; }
+  bool isMapped() const { return mapped_; }
+};
+}
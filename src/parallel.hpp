@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2018 Diogo Haruki Kykuta
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace haruki
+{
+
+/* number of threads to use when the caller asks for 0 (automatic) */
+inline int defaultNumThreads()
+{
+  int n = std::thread::hardware_concurrency();
+  return n > 0 ? n : 1;
+}
+
+/*
+ * Splits [begin, end) into numThreads contiguous blocks and calls
+ * f(blockBegin, blockEnd, threadIdx) for each one, on its own thread.
+ * With a single thread f runs on the caller's thread.
+ */
+template <class F>
+void parallelFor(int numThreads, long long begin, long long end, F f)
+{
+  if (numThreads <= 1 || end - begin <= 1)
+  {
+    f(begin, end, 0);
+    return;
+  }
+
+  std::vector<std::thread> threads;
+  long long blockSize = (end - begin + numThreads - 1) / numThreads;
+  for (int t = 0; t < numThreads; t++)
+  {
+    long long blockBegin = begin + t * blockSize;
+    long long blockEnd = std::min(end, blockBegin + blockSize);
+    if (blockBegin >= blockEnd)
+    {
+      break;
+    }
+    threads.push_back(std::thread(f, blockBegin, blockEnd, t));
+  }
+  for (auto it = threads.begin(); it != threads.end(); ++it)
+  {
+    it->join();
+  }
+}
+}
@@ -34,25 +34,17 @@ extern int hrk_pascoal_fallback;
 namespace haruki {
 
   void PascoalKSP::preproc(Graph &g, int s, int t, int k) {
-    haruki::GraphBuilder pg;
-    for (int i = 0; i < g.getNumVert(); i++) {
-      EdgeOut::range edges = g.getEdgesOut(i);
-      for (EdgeOut::iterator it = edges.begin(); it != edges.end(); ++it) {
-        int j = (*it).head;
-        pg.addEdge(j, i, g.getEdgeCost(i, j));
-      }
-    }
-    haruki::Graph h(pg);
-
-    std::vector<double> distances;
-    haruki::dijkstra::dijkstra_parents(h, t, s, false, dag_paths_next_, distances);
+    /* distances to t, searched on g's own reverse index instead of a
+     * transposed copy */
+    HugeVector<Weight> distances;
+    haruki::dijkstra::dijkstra_parents_reverse(g, t, s, false, dag_paths_next_, distances);
 
     EdgeList::range allEdges = g.getAllEdges();
     for (EdgeList::iterator it = allEdges.begin(); it != allEdges.end(); ++it) {
       int i = (*it).tail;
       int j = (*it).head;
-      double reducedCost = (*it).cost - distances[i] + distances[j];
-      (*it).cost = reducedCost;
+      Weight reducedCost = (*it).cost - distances[i] + distances[j];
+      g.setEdgeCost(it.getEdgeIdx(), reducedCost);
     }
   }
 
@@ -86,7 +78,7 @@ namespace haruki {
   Path PascoalKSP::generateCandidateAtEdge(Graph &h, int t, std::vector<Path> &R, Path &path, int j) {
     std::pair<int, int> edge = path.getEdge(j);
 
-    float minCostFound = -1;
+    Weight minCostFound = -1;
     int headSelected = -1;
 
     EdgeOut::range edges = h.getEdgesOut(edge.first);
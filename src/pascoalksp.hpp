@@ -35,7 +35,7 @@ class PascoalKSP : public YenKSP
 {
 protected:
   std::vector<haruki::Path> dag_paths_;
-  std::vector<int> dag_paths_next_;
+  HugeVector<int> dag_paths_next_;
 
   virtual Path generateCandidateAtEdge(Graph &h, int t, std::vector<Path> &R, Path &path, int j);
   Path fixCosts(const Graph &g, const Path &p);
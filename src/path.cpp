@@ -24,11 +24,11 @@
 
 namespace haruki {
 
-  void Path::addEdge(std::pair<int, int> edge, double edgeCost) {
+  void Path::addEdge(std::pair<int, int> edge, Weight edgeCost) {
     addEdge(edge.first, edge.second, edgeCost);
   }
 
-  void Path::addEdge(int tail, int head, double edgeCost) {
+  void Path::addEdge(int tail, int head, Weight edgeCost) {
     if (numVert_ == 0) {
       vertList_.push_back(tail);
       numVert_++;
@@ -62,6 +62,18 @@ namespace haruki {
     return sp;
   }
 
+  Path Path::relabel(const std::vector<int> &label) const {
+    Path rp;
+    rp.vertList_.reserve(numVert_);
+    for (int k = 0; k < numVert_; k++) {
+      rp.vertList_.push_back(label[vertList_[k]]);
+    }
+    rp.edgesCostList_ = edgesCostList_;
+    rp.numVert_ = numVert_;
+    rp.totalCost_ = totalCost_;
+    return rp;
+  }
+
   std::pair<int, int> Path::getEdge(int i) {
     return std::make_pair(vertList_[i], vertList_[i + 1]);
   }
@@ -70,7 +82,7 @@ namespace haruki {
     return EdgeInfo(vertList_[i], vertList_[i + 1], edgesCostList_[i]);
   }
 
-  double Path::getEdgeCost(int i) {
+  Weight Path::getEdgeCost(int i) {
     return edgesCostList_[i];
   }
 
@@ -32,25 +32,27 @@ class Path
 {
 private:
   std::vector<int> vertList_;
-  std::vector<double> edgesCostList_;
+  std::vector<Weight> edgesCostList_;
   int numVert_;
-  double totalCost_;
+  Weight totalCost_;
 
 public:
   Path() : numVert_(0), totalCost_(0) {}
   Path(int initialVertex) : numVert_(1), totalCost_(0) { vertList_.push_back(initialVertex); }
   const std::vector<int> &getVertList() const { return vertList_; };
-  void addEdge(std::pair<int, int> edge, double edgeCost);
-  void addEdge(int tail, int head, double edgeCost);
+  void addEdge(std::pair<int, int> edge, Weight edgeCost);
+  void addEdge(int tail, int head, Weight edgeCost);
   void addEdge(const EdgeInfo& edgeInfo);
   std::pair<int, int> getEdge(int i);
   EdgeInfo getEdgeInfo(int i);
-  double getEdgeCost(int i);
+  Weight getEdgeCost(int i);
 
   Path subpath(int i, int j);
+  /* same path with every vertex v replaced by label[v] */
+  Path relabel(const std::vector<int> &label) const;
 
   int size() const { return numVert_; }
-  double cost() const { return totalCost_; }
+  Weight cost() const { return totalCost_; }
   bool operator<(const haruki::Path &rhs) const;
   bool operator>(const haruki::Path &rhs) const;
   bool operator==(const haruki::Path &rhs) const;
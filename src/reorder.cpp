@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2018 Diogo Haruki Kykuta
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+*/
+#include "reorder.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "graph.hpp"
+
+namespace haruki
+{
+namespace reorder
+{
+
+bool parseStrategy(const std::string &name, Strategy &strategy)
+{
+  if (name == "none")
+  {
+    strategy = NONE;
+  }
+  else if (name == "bfs")
+  {
+    strategy = BFS;
+  }
+  else if (name == "rcm")
+  {
+    strategy = CUTHILL_MCKEE;
+  }
+  else if (name == "degree")
+  {
+    strategy = DEGREE;
+  }
+  else
+  {
+    return false;
+  }
+  return true;
+}
+
+static std::vector<int> outDegrees(Graph &g)
+{
+  int numVert = g.getNumVert();
+  Span<const EdgeIdx> firstEdgeEachV = g.getFirstEdgeEachV();
+  std::vector<int> degree(numVert);
+  for (int v = 0; v < numVert; v++)
+  {
+    EdgeIdx endIdx = (v + 1 < numVert ? firstEdgeEachV[v + 1] : g.getNumEdges());
+    degree[v] = endIdx - firstEdgeEachV[v];
+  }
+  return degree;
+}
+
+/*
+ * Appends to order every vertex reachable from root that is not visited
+ * yet, level by level. With byDegree the neighbours of each vertex are
+ * queued by increasing degree.
+ */
+static void breadthFirst(Graph &g, int root, const std::vector<int> &degree, bool byDegree,
+                         std::vector<bool> &visited, std::vector<int> &order)
+{
+  size_t queueHead = order.size();
+  visited[root] = true;
+  order.push_back(root);
+  while (queueHead < order.size())
+  {
+    int v = order[queueHead++];
+    size_t levelBegin = order.size();
+    EdgeOut::range edges = g.getEdgesOut(v);
+    for (auto it = edges.begin(); it != edges.end(); ++it)
+    {
+      int w = it.head();
+      if (!visited[w])
+      {
+        visited[w] = true;
+        order.push_back(w);
+      }
+    }
+    if (byDegree)
+    {
+      std::stable_sort(order.begin() + levelBegin, order.end(), [&degree](int a, int b) {
+        return degree[a] < degree[b];
+      });
+    }
+  }
+}
+
+std::vector<int> computeOrder(Graph &g, Strategy strategy)
+{
+  int numVert = g.getNumVert();
+  std::vector<int> order;
+  order.reserve(numVert);
+
+  if (strategy == NONE)
+  {
+    for (int v = 0; v < numVert; v++)
+    {
+      order.push_back(v);
+    }
+    return order;
+  }
+
+  std::vector<int> degree = outDegrees(g);
+
+  if (strategy == DEGREE)
+  {
+    for (int v = 0; v < numVert; v++)
+    {
+      order.push_back(v);
+    }
+    std::stable_sort(order.begin(), order.end(), [&degree](int a, int b) {
+      return degree[a] > degree[b];
+    });
+    return order;
+  }
+
+  std::vector<bool> visited(numVert, false);
+  if (strategy == BFS)
+  {
+    for (int v = 0; v < numVert; v++)
+    {
+      if (!visited[v])
+      {
+        breadthFirst(g, v, degree, false, visited, order);
+      }
+    }
+    return order;
+  }
+
+  /* Cuthill-McKee roots each component at its unvisited vertex of least
+   * degree, then the whole order is reversed */
+  std::vector<int> byDegree(numVert);
+  for (int v = 0; v < numVert; v++)
+  {
+    byDegree[v] = v;
+  }
+  std::stable_sort(byDegree.begin(), byDegree.end(), [&degree](int a, int b) {
+    return degree[a] < degree[b];
+  });
+  for (int i = 0; i < numVert; i++)
+  {
+    if (!visited[byDegree[i]])
+    {
+      breadthFirst(g, byDegree[i], degree, true, visited, order);
+    }
+  }
+  std::reverse(order.begin(), order.end());
+  return order;
+}
+
+Graph *reorderGraph(Graph &g, Strategy strategy, int numThreads)
+{
+  int numVert = g.getNumVert();
+  std::vector<int> order = computeOrder(g, strategy);
+  std::vector<int> newId(numVert);
+  std::vector<int> originalIds(numVert);
+  for (int i = 0; i < numVert; i++)
+  {
+    newId[order[i]] = i;
+    /* g may itself be a reordered graph, keep pointing at the input ids */
+    originalIds[i] = g.toOriginalId(order[i]);
+  }
+
+  GraphBuilder pg;
+  pg.setNumVert(numVert);
+  pg.setNumEdges(g.getNumEdges());
+  for (auto it : g.getAllEdges())
+  {
+    pg.addEdge(newId[it.tail], newId[it.head], it.cost);
+  }
+  pg.setOriginalIds(originalIds);
+  pg.setShortcuts(g.getShortcuts());
+  return new Graph(std::move(pg), numThreads);
+}
+
+}
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2018 Diogo Haruki Kykuta
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <string>
+#include <vector>
+#include "graph.hpp"
+
+namespace haruki {
+  namespace reorder {
+    /*
+     * Vertex orderings that put vertices visited together next to each
+     * other in the CSR arrays:
+     *  - BFS: breadth first order over the outgoing edges, restarted from
+     *    the lowest unvisited vertex for each component
+     *  - CUTHILL_MCKEE: reverse Cuthill-McKee, BFS from a vertex of minimum
+     *    degree visiting neighbours by increasing degree
+     *  - DEGREE: vertices sorted by decreasing out-degree
+     */
+    enum Strategy { NONE, BFS, CUTHILL_MCKEE, DEGREE };
+
+    bool parseStrategy(const std::string &name, Strategy &strategy);
+
+    /* order[newId] is the vertex of g that gets id newId */
+    std::vector<int> computeOrder(Graph &g, Strategy strategy);
+
+    /*
+     * Builds a copy of g, without its removed edges, with the vertices
+     * renumbered by the given strategy. The copy remembers the ids it was built from, see
+     * Graph::toInternalId and Graph::getOriginalIds.
+     */
+    Graph *reorderGraph(Graph &g, Strategy strategy, int numThreads = 0);
+  }
+}
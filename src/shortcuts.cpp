@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2018 Diogo Haruki Kykuta
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+*/
+#include "shortcuts.hpp"
+
+namespace haruki
+{
+
+const ShortcutTable::Chain *ShortcutTable::find(int tail, int head) const
+{
+  auto it = chains_.find(key(tail, head));
+  return it == chains_.end() ? nullptr : &it->second;
+}
+
+Path ShortcutTable::expand(Path p) const
+{
+  if (p.size() < 2)
+  {
+    return p;
+  }
+  Path expanded(p.getVertList()[0]);
+  for (int i = 0; i + 1 < p.size(); i++)
+  {
+    EdgeInfo edge = p.getEdgeInfo(i);
+    const Chain *chain = find(edge.tail, edge.head);
+    if (chain == nullptr)
+    {
+      expanded.addEdge(edge);
+      continue;
+    }
+    int tail = edge.tail;
+    for (size_t j = 0; j < chain->vertices.size(); j++)
+    {
+      expanded.addEdge(tail, chain->vertices[j], chain->costs[j]);
+      tail = chain->vertices[j];
+    }
+    expanded.addEdge(tail, edge.head, chain->costs.back());
+  }
+  return expanded;
+}
+
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2018 Diogo Haruki Kykuta
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "path.hpp"
+
+namespace haruki
+{
+
+/*
+ * Edges that stand for a chain of contracted vertices (see contract.hpp),
+ * by the input ids of their ends. A chain lists the input ids of the
+ * vertices it went through and the costs of its edges, one more than the
+ * vertices.
+ */
+class ShortcutTable
+{
+public:
+  struct Chain
+  {
+    std::vector<int> vertices;
+    std::vector<Weight> costs;
+  };
+
+  void add(int tail, int head, const Chain &chain) { chains_[key(tail, head)] = chain; }
+  const Chain *find(int tail, int head) const;
+  size_t size() const { return chains_.size(); }
+
+  /* p, in input ids, with each shortcut replaced by its chain */
+  Path expand(Path p) const;
+
+private:
+  std::unordered_map<uint64_t, Chain> chains_;
+
+  static uint64_t key(int tail, int head) { return ((uint64_t)(uint32_t)tail << 32) | (uint32_t)head; }
+};
+}
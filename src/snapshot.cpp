@@ -0,0 +1,390 @@
+/*
+ * Copyright (C) 2018 Diogo Haruki Kykuta
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+*/
+#include "snapshot.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <type_traits>
+#include "mappedfile.hpp"
+
+namespace haruki
+{
+namespace snapshot
+{
+
+static const char kMagic[8] = {'H', 'R', 'K', 'G', 'R', 'A', 'P', 'H'};
+static const uint32_t kVersion = 2;
+static const uint32_t kByteOrder = 0x01020304;
+static const uint64_t kAlignment = 64;
+
+enum Section
+{
+  FIRST_EDGE,
+  HEADS,
+  COSTS,
+  FIRST_EDGE_REVERSE,
+  REVERSE_TRACE,
+  REVERSE_TAILS,
+  ORIGINAL_IDS,
+  INTERNAL_IDS,
+  NUM_SECTIONS
+};
+
+enum Flags
+{
+  SYMMETRIC = 1
+};
+
+/* fixed-width fields only, the layout does not depend on the compiler */
+struct Header
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t byteOrder;
+  uint8_t edgeIdxBytes;
+  uint8_t vertexBytes;
+  uint8_t weightBytes;
+  uint8_t weightIsFloat;
+  uint32_t flags;
+  int64_t numVert;
+  int64_t numEdges;
+  /* byte offset of each section in the file, 0 when it is absent */
+  uint64_t offsets[NUM_SECTIONS];
+  uint64_t sizes[NUM_SECTIONS];
+};
+
+static uint64_t alignUp(uint64_t offset)
+{
+  return (offset + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+template <class V>
+static void addSection(Header &header, Section section, const V &array, uint64_t &end)
+{
+  if (array.empty())
+  {
+    return;
+  }
+  header.offsets[section] = alignUp(end);
+  header.sizes[section] = array.size() * sizeof(array[0]);
+  end = header.offsets[section] + header.sizes[section];
+}
+
+template <class V>
+static void writeSection(std::ofstream &out, const Header &header, Section section, const V &array)
+{
+  if (header.sizes[section] == 0)
+  {
+    return;
+  }
+  static const char padding[kAlignment] = {};
+  out.write(padding, header.offsets[section] - out.tellp());
+  out.write(reinterpret_cast<const char *>(array.data()), header.sizes[section]);
+}
+
+bool save(const Graph &g, const std::string &filepath)
+{
+  if (g.hasShortcuts())
+  {
+    std::cerr << "Contracted graphs cannot be saved as snapshots" << std::endl;
+    return false;
+  }
+  if (g.hasDelta())
+  {
+    std::cerr << "Graphs with inserted or deleted edges have to be compacted before being saved" << std::endl;
+    return false;
+  }
+  std::shared_ptr<const GraphTopology> topology = g.getTopology();
+  /* the costs rewritten on g, if any, rather than those of the topology */
+  Span<const Weight> costs = g.getCosts();
+  topology->decompress();
+  if (!topology->symmetric)
+  {
+    topology->buildReverse();
+  }
+
+  Header header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.byteOrder = kByteOrder;
+  header.edgeIdxBytes = sizeof(EdgeIdx);
+  header.vertexBytes = sizeof(int);
+  header.weightBytes = sizeof(Weight);
+  header.weightIsFloat = std::is_floating_point<Weight>::value;
+  header.flags = (topology->symmetric ? SYMMETRIC : 0);
+  header.numVert = topology->numVert;
+  header.numEdges = topology->numEdges;
+
+  uint64_t end = sizeof(header);
+  addSection(header, FIRST_EDGE, topology->firstEdgeEachV, end);
+  addSection(header, HEADS, topology->heads, end);
+  addSection(header, COSTS, costs, end);
+  if (!topology->symmetric)
+  {
+    addSection(header, FIRST_EDGE_REVERSE, topology->firstEdgeReverseV, end);
+    addSection(header, REVERSE_TRACE, topology->reverseTrace, end);
+    addSection(header, REVERSE_TAILS, topology->reverseTails, end);
+  }
+  addSection(header, ORIGINAL_IDS, topology->originalIds, end);
+  addSection(header, INTERNAL_IDS, topology->internalIds, end);
+
+  std::ofstream out(filepath, std::ios::binary | std::ios::trunc);
+  if (!out.is_open())
+  {
+    std::cerr << "Could not write " << filepath << std::endl;
+    return false;
+  }
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  writeSection(out, header, FIRST_EDGE, topology->firstEdgeEachV);
+  writeSection(out, header, HEADS, topology->heads);
+  writeSection(out, header, COSTS, costs);
+  writeSection(out, header, FIRST_EDGE_REVERSE, topology->firstEdgeReverseV);
+  writeSection(out, header, REVERSE_TRACE, topology->reverseTrace);
+  writeSection(out, header, REVERSE_TAILS, topology->reverseTails);
+  writeSection(out, header, ORIGINAL_IDS, topology->originalIds);
+  writeSection(out, header, INTERNAL_IDS, topology->internalIds);
+  out.close();
+  if (!out)
+  {
+    std::cerr << "Could not write " << filepath << std::endl;
+    return false;
+  }
+  return true;
+}
+
+/* whether the section holds exactly count elements of the given size */
+static bool fitsSection(const MappedFile &file, const Header &header, Section section, uint64_t elementBytes, int64_t count)
+{
+  uint64_t size = count * elementBytes;
+  return header.sizes[section] == size && header.offsets[section] <= file.size() && size <= file.size() - header.offsets[section];
+}
+
+/* the small per-vertex id arrays are copied */
+static bool readSection(const MappedFile &file, const Header &header, Section section, std::vector<int> &array, int64_t count)
+{
+  if (!fitsSection(file, header, section, sizeof(int), count))
+  {
+    return false;
+  }
+  array.resize(count);
+  if (count > 0)
+  {
+    memcpy(&array[0], file.data() + header.offsets[section], count * sizeof(int));
+  }
+  return true;
+}
+
+/* the CSR arrays view the file, see HugePageAllocator */
+template <class T>
+static bool readSection(const MappedFile &file, const Header &header, Section section, HugeVector<T> &array, int64_t count)
+{
+  if (!fitsSection(file, header, section, sizeof(T), count))
+  {
+    return false;
+  }
+  const T *view = reinterpret_cast<const T *>(file.data() + header.offsets[section]);
+  array = HugeVector<T>(count, HugePageAllocator<T>(view, count));
+  return true;
+}
+
+/* offsets non-decreasing and within the edges */
+template <class V>
+static bool isOffsetArray(const V &offsets, EdgeIdx numEdges)
+{
+  EdgeIdx prev = 0;
+  for (auto it = offsets.begin(); it != offsets.end(); ++it)
+  {
+    if (*it < prev || *it > numEdges)
+    {
+      return false;
+    }
+    prev = *it;
+  }
+  return true;
+}
+
+/* every value in [0, bound) */
+template <class V, class T>
+static bool isInRange(const V &values, T bound)
+{
+  for (auto it = values.begin(); it != values.end(); ++it)
+  {
+    if (*it < 0 || *it >= bound)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* what useSymmetricStorage() checked: heads strictly increasing in each
+ * adjacency and a twin for every edge, found the way EdgeIn looks it up */
+static bool hasTwins(const GraphTopology &topology)
+{
+  const HugeVector<EdgeIdx> &firstEdgeEachV = topology.firstEdgeEachV;
+  const int *heads = topology.heads.data();
+  auto end = [&](int v) { return v + 1 < topology.numVert ? firstEdgeEachV[v + 1] : topology.numEdges; };
+  for (int v = 0; v < topology.numVert; v++)
+  {
+    for (EdgeIdx idx = firstEdgeEachV[v]; idx < end(v); idx++)
+    {
+      int head = heads[idx];
+      if (idx > firstEdgeEachV[v] && head <= heads[idx - 1])
+      {
+        return false;
+      }
+      const int *twin = std::lower_bound(heads + firstEdgeEachV[head], heads + end(head), v);
+      if (twin == heads + end(head) || *twin != v)
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/* internalIds maps each vertex back from its input id and nothing else,
+ * so the input ids are distinct */
+static bool areInverse(const std::vector<int> &originalIds, const std::vector<int> &internalIds)
+{
+  if (originalIds.empty() != internalIds.empty())
+  {
+    return false;
+  }
+  for (size_t v = 0; v < originalIds.size(); v++)
+  {
+    if (originalIds[v] < 0 || originalIds[v] >= (int)internalIds.size() || internalIds[originalIds[v]] != (int)v)
+    {
+      return false;
+    }
+  }
+  size_t mapped = 0;
+  for (auto it = internalIds.begin(); it != internalIds.end(); ++it)
+  {
+    if (*it < -1 || *it >= (int)originalIds.size())
+    {
+      return false;
+    }
+    mapped += (*it != -1);
+  }
+  return mapped == originalIds.size();
+}
+
+/* one pass over each array, so that nothing read from the file can index
+ * out of range later */
+static bool isConsistent(const GraphTopology &topology)
+{
+  return isOffsetArray(topology.firstEdgeEachV, topology.numEdges) &&
+         isInRange(topology.heads, topology.numVert) &&
+         isOffsetArray(topology.firstEdgeReverseV, topology.numEdges) &&
+         isInRange(topology.reverseTrace, topology.numEdges) &&
+         isInRange(topology.reverseTails, topology.numVert) &&
+         (!topology.symmetric || hasTwins(topology)) &&
+         areInverse(topology.originalIds, topology.internalIds);
+}
+
+/*
+ * Nothing is copied but the id arrays: the topology keeps the file mapped
+ * and its arrays read it in place, so processes loading the same snapshot
+ * share its pages through the page cache. Checking the arrays still reads
+ * each of them once.
+ */
+Graph *load(const std::string &filepath)
+{
+  std::shared_ptr<MappedFile> mapping = std::make_shared<MappedFile>();
+  const MappedFile &file = *mapping;
+  if (!mapping->open(filepath, false))
+  {
+    std::cerr << "Could not open " << filepath << std::endl;
+    return nullptr;
+  }
+  Header header;
+  if (file.size() < sizeof(header))
+  {
+    std::cerr << filepath << " is not a graph snapshot" << std::endl;
+    return nullptr;
+  }
+  memcpy(&header, file.data(), sizeof(header));
+  if (memcmp(header.magic, kMagic, sizeof(kMagic)) != 0)
+  {
+    std::cerr << filepath << " is not a graph snapshot" << std::endl;
+    return nullptr;
+  }
+  if (header.version != kVersion)
+  {
+    std::cerr << "Snapshot version " << header.version << " is not supported, expected " << kVersion << std::endl;
+    return nullptr;
+  }
+  if (header.byteOrder != kByteOrder || header.edgeIdxBytes != sizeof(EdgeIdx) || header.vertexBytes != sizeof(int) ||
+      header.weightBytes != sizeof(Weight) || header.weightIsFloat != std::is_floating_point<Weight>::value)
+  {
+    std::cerr << "Snapshot was saved by a build with other edge index or weight types" << std::endl;
+    return nullptr;
+  }
+
+  std::shared_ptr<GraphTopology> topology = std::make_shared<GraphTopology>();
+  topology->mapping = mapping;
+  topology->numVert = header.numVert;
+  topology->numEdges = header.numEdges;
+  topology->symmetric = (header.flags & SYMMETRIC) != 0;
+  bool valid = header.numVert >= 0 && header.numVert <= std::numeric_limits<int>::max() && header.numEdges >= 0 &&
+               readSection(file, header, FIRST_EDGE, topology->firstEdgeEachV, header.numVert) &&
+               readSection(file, header, HEADS, topology->heads, header.numEdges) &&
+               readSection(file, header, COSTS, topology->costs, header.numEdges);
+  if (valid && header.sizes[REVERSE_TRACE] != 0)
+  {
+    valid = readSection(file, header, FIRST_EDGE_REVERSE, topology->firstEdgeReverseV, header.numVert) &&
+            readSection(file, header, REVERSE_TRACE, topology->reverseTrace, header.numEdges) &&
+            readSection(file, header, REVERSE_TAILS, topology->reverseTails, header.numEdges);
+  }
+  if (valid && header.sizes[ORIGINAL_IDS] != 0)
+  {
+    valid = readSection(file, header, ORIGINAL_IDS, topology->originalIds, header.numVert);
+  }
+  /* as long as the largest input id, only bounded by the file size */
+  if (valid && header.sizes[INTERNAL_IDS] != 0)
+  {
+    valid = header.sizes[INTERNAL_IDS] % sizeof(int) == 0 &&
+            readSection(file, header, INTERNAL_IDS, topology->internalIds, header.sizes[INTERNAL_IDS] / sizeof(int));
+  }
+  valid = valid && isConsistent(*topology);
+  if (!valid)
+  {
+    std::cerr << filepath << " is truncated or corrupt" << std::endl;
+    return nullptr;
+  }
+  return new Graph(std::shared_ptr<const GraphTopology>(topology));
+}
+
+bool isSnapshot(const std::string &filepath)
+{
+  char magic[sizeof(kMagic)];
+  std::ifstream in(filepath, std::ios::binary);
+  return in.read(magic, sizeof(magic)) && memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+}
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2018 Diogo Haruki Kykuta
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <string>
+#include "graph.hpp"
+
+namespace haruki {
+  namespace snapshot {
+    /*
+     * Binary image of a finished topology: the forward arrays with the
+     * costs g has now, the reverse index unless the graph is symmetric, and
+     * the input ids of a renumbered graph (see reorder.hpp, trim.hpp).
+     * Edges removed on g are not saved.
+     *
+     * Arrays are stored as they sit in memory, each aligned to 64 bytes, so
+     * a snapshot is only read back by a build with the same EdgeIdx and
+     * Weight types and byte order. Contracted graphs cannot be saved, their
+     * shortcut chains only live in memory, and neither can graphs with a
+     * delta overlay: compact it first (Graph::compactDelta()).
+     */
+    bool save(const Graph &g, const std::string &filepath);
+
+    /* the graph reads its arrays from the file, mapped for as long as its
+     * topology lives (see GraphTopology::mapping). nullptr, with a message,
+     * if the file is not a snapshot this build can read, holds offsets,
+     * vertex ids or edge indices out of range, input ids that repeat, or
+     * claims a symmetric graph some edge of which has no twin */
+    Graph *load(const std::string &filepath);
+
+    /* whether the file starts like a snapshot, of any version */
+    bool isSnapshot(const std::string &filepath);
+  }
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2018 Diogo Haruki Kykuta
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <vector>
+#include "edgeidx.hpp"
+
+namespace haruki
+{
+
+/*
+ * Non-owning view of a contiguous array, valid while the array it was taken
+ * from is alive and not resized. Sizes and indices are EdgeIdx, as wide as
+ * the edge arrays it views.
+ */
+template <class T>
+class Span
+{
+private:
+  T *data_;
+  EdgeIdx size_;
+
+public:
+  Span() : data_(nullptr), size_(0) {}
+  Span(T *data, EdgeIdx size) : data_(data), size_(size) {}
+
+  template <class U, class A>
+  Span(const std::vector<U, A> &v) : data_(v.data()), size_(v.size()) {}
+
+  T &operator[](EdgeIdx i) const { return data_[i]; }
+  EdgeIdx size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  T *data() const { return data_; }
+  T *begin() const { return data_; }
+  T *end() const { return data_ + size_; }
+};
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2018 Diogo Haruki Kykuta
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+*/
+#include "trim.hpp"
+#include "path.hpp"
+#include "dijkstra.hpp"
+#include <vector>
+
+namespace haruki
+{
+namespace trim
+{
+
+Graph *trimToCore(Graph &g, int s, int t, double stretch, int numThreads)
+{
+  int numVert = g.getNumVert();
+  HugeVector<int> fromS, toT;
+  HugeVector<Weight> distFromS, distToT;
+  dijkstra::dijkstra_parents(g, s, t, false, fromS, distFromS);
+  dijkstra::dijkstra_parents_reverse(g, t, s, false, toT, distToT);
+
+  bool bounded = stretch > 0 && fromS[t] != -1;
+  double maxCost = bounded ? stretch * distFromS[t] : 0;
+  std::vector<int> newId(numVert, -1);
+  std::vector<int> originalIds;
+  for (int v = 0; v < numVert; v++)
+  {
+    bool keep = v == s || v == t;
+    if (!keep && fromS[v] != -1 && toT[v] != -1)
+    {
+      keep = !bounded || distFromS[v] + distToT[v] <= maxCost;
+    }
+    if (keep)
+    {
+      newId[v] = originalIds.size();
+      /* g may itself be a renumbered graph, keep pointing at the input ids */
+      originalIds.push_back(g.toOriginalId(v));
+    }
+  }
+
+  GraphBuilder pg;
+  pg.setNumVert(originalIds.size());
+  for (auto it : g.getAllEdges())
+  {
+    if (newId[it.tail] != -1 && newId[it.head] != -1)
+    {
+      pg.addEdge(newId[it.tail], newId[it.head], it.cost);
+    }
+  }
+  pg.setOriginalIds(originalIds);
+  pg.setShortcuts(g.getShortcuts());
+  return new Graph(std::move(pg), numThreads);
+}
+
+}
+}
@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2018 Diogo Haruki Kykuta
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+*/
+#pragma once
+
+#include "graph.hpp"
+
+namespace haruki {
+  namespace trim {
+    /*
+     * Builds the subgraph of g induced by its s-t core: the vertices
+     * reachable from s that also reach t, the only ones a path from s to t
+     * can go through. With stretch > 0 a vertex v is kept only if
+     * d(s, v) + d(v, t) <= stretch * d(s, t), which also drops the paths
+     * longer than that. s and t are always kept, even when t cannot be
+     * reached.
+     *
+     * s and t are ids of g. Like reorder::reorderGraph, the subgraph drops
+     * removed edges and remembers the input ids (Graph::toInternalId,
+     * Graph::getOriginalIds), so KSP::run takes and returns those.
+     */
+    Graph *trimToCore(Graph &g, int s, int t, double stretch = 0, int numThreads = 0);
+  }
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2018 Diogo Haruki Kykuta
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <cstdint>
+
+namespace haruki
+{
+
+/*
+ * Type of edge costs, distances and path costs. double unless the build
+ * defines HRK_WEIGHT_TYPE_ (see HRK_WEIGHT_TYPE in CMakeLists.txt), e.g.
+ * int32_t or int64_t for DIMACS graphs, whose arc weights are integers:
+ * costs take half the memory with int32_t and ties between paths are
+ * compared exactly.
+ */
+#ifdef HRK_WEIGHT_TYPE_
+typedef HRK_WEIGHT_TYPE_ Weight;
+#else
+typedef double Weight;
+#endif
+}
@@ -121,15 +121,10 @@ void YenKSP::removeEdgesSharedPrefix(Graph &h, int t, std::vector<Path> &R, Path
   auxEdge = path.getEdge(j);
   h.removeEdge(auxEdge.first, auxEdge.second);
 
+  const std::vector<int> &vertList = path.getVertList();
   for (int i = 0; i < j; i++)
   {
-    auxEdge = path.getEdge(i);
-
-    EdgeOut::range edges = h.getEdgesOut(auxEdge.first);
-    for (EdgeOut::iterator it = edges.begin(); it != edges.end(); ++it)
-    {
-      h.removeEdge((*it).tail, (*it).head);
-    }
+    h.disableVertex(vertList[i]);
   }
 }
 }
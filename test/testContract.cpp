@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2018 Diogo Haruki Kykuta
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+*/
+#include <gtest/gtest.h>
+#include "../src/contract.hpp"
+#include "../src/yenksp.hpp"
+#include "../src/ksp.hpp"
+#include "../src/path.hpp"
+#include "../src/graph.hpp"
+#include "testHelpers.hpp"
+
+static haruki::GraphBuilder contractTestGraph() {
+    haruki::GraphBuilder pg;
+    pg.setNumVert(9);
+    /* two-way chain 0 - 1 - 2 - 3 */
+    pg.addEdge(0, 1, 1);
+    pg.addEdge(1, 2, 2);
+    pg.addEdge(2, 3, 3);
+    pg.addEdge(3, 2, 1);
+    pg.addEdge(2, 1, 1);
+    pg.addEdge(1, 0, 1);
+    /* one-way chains 0 -> 6 -> 3 and 3 -> 4 -> 5, parallel to others */
+    pg.addEdge(0, 6, 2);
+    pg.addEdge(6, 3, 5);
+    pg.addEdge(3, 4, 1);
+    pg.addEdge(4, 5, 1);
+    pg.addEdge(3, 5, 10);
+    /* cycle 5 -> 7 -> 8 -> 5 */
+    pg.addEdge(5, 7, 1);
+    pg.addEdge(7, 8, 1);
+    pg.addEdge(8, 5, 1);
+    return pg;
+}
+
+TEST(CONTRACT, CHAINS_BECOME_EDGES) {
+    haruki::Graph g(contractTestGraph());
+
+    haruki::Graph *h = haruki::contract::contractChains(g, 0, 5);
+    ASSERT_EQ(5, h->getNumVert());
+    ASSERT_EQ(7, h->getNumEdges());
+    ASSERT_EQ(-1, h->toInternalId(1));
+    ASSERT_EQ(-1, h->toInternalId(2));
+    ASSERT_EQ(-1, h->toInternalId(7));
+    ASSERT_NE(-1, h->toInternalId(4));
+    ASSERT_NE(-1, h->toInternalId(6));
+    ASSERT_DOUBLE_EQ(6, h->getEdgeCost(h->toInternalId(0), h->toInternalId(3)));
+    ASSERT_DOUBLE_EQ(3, h->getEdgeCost(h->toInternalId(3), h->toInternalId(0)));
+
+    ASSERT_TRUE(h->hasShortcuts());
+    ASSERT_EQ(2, h->getShortcuts()->size());
+    const haruki::ShortcutTable::Chain *chain = h->getShortcuts()->find(0, 3);
+    ASSERT_TRUE(chain != nullptr);
+    ASSERT_EQ(std::vector<int>({1, 2}), chain->vertices);
+    ASSERT_EQ(3, chain->costs.size());
+
+    haruki::KSP<haruki::YenKSP> yen;
+    std::vector<haruki::Path> expected = yen.run(g, 0, 5, 10);
+    std::vector<haruki::Path> result = yen.run(*h, 0, 5, 10);
+    ASSERT_EQ(4, expected.size());
+    ASSERT_NO_FATAL_FAILURE(assertSamePaths(expected, result));
+
+    delete h;
+}
+
+TEST(CONTRACT, CONTRACTED_TWICE) {
+    haruki::GraphBuilder pg;
+    pg.addEdge(0, 1, 1);
+    pg.addEdge(1, 2, 2);
+    pg.addEdge(2, 3, 3);
+    haruki::Graph g(pg);
+
+    /* 1 is kept the first time, its edge to 3 already is a shortcut */
+    haruki::Graph *h = haruki::contract::contractChains(g, 1, 3);
+    ASSERT_EQ(3, h->getNumVert());
+    haruki::Graph *h2 = haruki::contract::contractChains(*h, h->toInternalId(0), h->toInternalId(3));
+    ASSERT_EQ(2, h2->getNumVert());
+    ASSERT_EQ(1, h2->getNumEdges());
+    const haruki::ShortcutTable::Chain *chain = h2->getShortcuts()->find(0, 3);
+    ASSERT_TRUE(chain != nullptr);
+    ASSERT_EQ(std::vector<int>({1, 2}), chain->vertices);
+    ASSERT_DOUBLE_EQ(1, chain->costs[0]);
+    ASSERT_DOUBLE_EQ(2, chain->costs[1]);
+    ASSERT_DOUBLE_EQ(3, chain->costs[2]);
+
+    haruki::KSP<haruki::YenKSP> yen;
+    std::vector<haruki::Path> result = yen.run(*h2, 0, 3, 2);
+    ASSERT_EQ(1, result.size());
+    ASSERT_DOUBLE_EQ(6, result[0].cost());
+    ASSERT_EQ(std::vector<int>({0, 1, 2, 3}), result[0].getVertList());
+
+    delete h;
+    delete h2;
+}
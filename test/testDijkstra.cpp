@@ -80,8 +80,8 @@ TEST(DIJKSTRA, PARENTS) {
 
     haruki::Graph g(pg);
 
-    std::vector<int> parents;
-    std::vector<double> distances;
+    haruki::HugeVector<int> parents;
+    haruki::HugeVector<haruki::Weight> distances;
 
     haruki::dijkstra::dijkstra_parents(g, 0, 3, false, parents, distances);
     ASSERT_EQ(5, parents.size());
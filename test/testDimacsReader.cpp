@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2018 Diogo Haruki Kykuta
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+*/
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include "../src/dimacsreader.hpp"
+#include "../src/graph.hpp"
+
+static std::string writeGrFile(const std::string &name, const std::string &text) {
+    std::string path = ::testing::TempDir() + name;
+    std::ofstream out(path, std::ios::binary);
+    out << text;
+    return path;
+}
+
+TEST(DIMACS, MAPPED_READER_MATCHES_STREAM_READER) {
+    std::string path = writeGrFile("hrk_dimacs.gr",
+        "c a comment line\n"
+        "p sp 5 7\n"
+        "\n"
+        "a 1 2 10\n"
+        "a 2 3 20\r\n"
+        "  a 3 1 5\n"
+        "a 1 2 4\n"
+        "c a 4 5 1\n"
+        "a 4 5 7\n"
+        "a 3 4 8");
+
+    haruki::GraphBuilder streamed, mapped;
+    ASSERT_TRUE(haruki::dimacs::readGrFile(path, streamed));
+    ASSERT_TRUE(haruki::dimacs::readGrFileMapped(path, mapped));
+    std::remove(path.c_str());
+
+    ASSERT_EQ(5, mapped.getNumVert());
+    ASSERT_EQ(6, mapped.getEdges().size());
+    ASSERT_EQ(streamed.getEdges().size(), mapped.getEdges().size());
+    for (size_t i = 0; i < mapped.getEdges().size(); i++) {
+        ASSERT_EQ(streamed.getEdges()[i].tail, mapped.getEdges()[i].tail);
+        ASSERT_EQ(streamed.getEdges()[i].head, mapped.getEdges()[i].head);
+        ASSERT_DOUBLE_EQ(streamed.getEdges()[i].cost, mapped.getEdges()[i].cost);
+    }
+    /* the first of the repeated arcs is kept */
+    haruki::Graph g(mapped);
+    ASSERT_EQ(5, g.getNumEdges());
+    ASSERT_DOUBLE_EQ(10, g.getEdgeCost(0, 1));
+
+    ASSERT_FALSE(haruki::dimacs::readGrFileMapped(path, mapped));
+}
+
+TEST(DIMACS, REPEATED_EDGES_POLICY) {
+    haruki::GraphBuilder pg;
+    pg.addEdge(2, 0, 3);
+    pg.addEdge(0, 1, 2);
+    pg.addEdge(2, 0, 1);
+    pg.addEdge(0, 1, 4);
+    pg.addEdge(1, 0, 5);
+    pg.addEdge(2, 0, 1);
+    pg.addEdge(0, 2, 6);
+
+    haruki::Graph all(pg);
+    ASSERT_EQ(7, all.getNumEdges());
+
+    pg.setRepeatedEdges(haruki::KEEP_FIRST_REPEATED);
+    haruki::Graph first(pg);
+    ASSERT_EQ(4, first.getNumEdges());
+    ASSERT_DOUBLE_EQ(2, first.getEdgeCost(0, 1));
+    ASSERT_DOUBLE_EQ(6, first.getEdgeCost(0, 2));
+    ASSERT_DOUBLE_EQ(5, first.getEdgeCost(1, 0));
+    ASSERT_DOUBLE_EQ(3, first.getEdgeCost(2, 0));
+
+    pg.setRepeatedEdges(haruki::KEEP_MIN_COST_REPEATED);
+    haruki::Graph cheapest(pg);
+    ASSERT_EQ(4, cheapest.getNumEdges());
+    ASSERT_DOUBLE_EQ(2, cheapest.getEdgeCost(0, 1));
+    ASSERT_DOUBLE_EQ(1, cheapest.getEdgeCost(2, 0));
+    ASSERT_EQ(3, cheapest.getNumVert());
+}
+
+TEST(DIMACS, CHUNKED_PARSE_MATCHES_SINGLE_THREAD) {
+    /* large enough to be split, with arcs repeated across chunks */
+    std::string text = "c chunked\np sp 3000 0\n";
+    for (int i = 0; i < 100000; i++) {
+        std::stringstream line;
+        line << "a " << i % 3000 + 1 << " " << (i * 13) % 50 + 1 << " " << i % 97 << "\n";
+        text += line.str();
+    }
+    std::string path = writeGrFile("hrk_chunked.gr", text);
+
+    haruki::GraphBuilder single, chunked;
+    ASSERT_TRUE(haruki::dimacs::readGrFileMapped(path, single, 1));
+    ASSERT_TRUE(haruki::dimacs::readGrFileMapped(path, chunked, 5));
+    std::remove(path.c_str());
+
+    ASSERT_EQ(3000, chunked.getNumVert());
+    ASSERT_EQ(single.getEdges().size(), chunked.getEdges().size());
+    for (size_t i = 0; i < single.getEdges().size(); i++) {
+        ASSERT_EQ(single.getEdges()[i].tail, chunked.getEdges()[i].tail);
+        ASSERT_EQ(single.getEdges()[i].head, chunked.getEdges()[i].head);
+        ASSERT_DOUBLE_EQ(single.getEdges()[i].cost, chunked.getEdges()[i].cost);
+    }
+    haruki::Graph g(chunked, 3);
+    /* u fixes v, so each tail has a single distinct arc */
+    ASSERT_EQ(3000, g.getNumEdges());
+}
+
+static void expectSameGraph(haruki::Graph &expected, haruki::Graph &actual) {
+    ASSERT_EQ(expected.getNumVert(), actual.getNumVert());
+    ASSERT_EQ(expected.getNumEdges(), actual.getNumEdges());
+    std::vector<haruki::EdgeInfo> expectedEdges = expected.getEdgeInfoList();
+    std::vector<haruki::EdgeInfo> actualEdges = actual.getEdgeInfoList();
+    for (size_t i = 0; i < expectedEdges.size(); i++) {
+        ASSERT_EQ(expectedEdges[i].tail, actualEdges[i].tail);
+        ASSERT_EQ(expectedEdges[i].head, actualEdges[i].head);
+        ASSERT_DOUBLE_EQ(expectedEdges[i].cost, actualEdges[i].cost);
+    }
+}
+
+TEST(DIMACS, DIRECT_LOAD_MATCHES_BUILDER) {
+    /* large enough to be split, with repeated arcs in different chunks */
+    std::string text = "c direct\np sp 400 0\n";
+    for (int i = 0; i < 100000; i++) {
+        std::stringstream line;
+        line << "a " << (i * 7) % 397 + 1 << " " << (i * 11) % 400 + 1 << " " << i % 13 << "\n";
+        text += line.str();
+    }
+    /* arcs of the last vertices out of order */
+    text += "a 400 3 1\na 400 1 2\na 400 3 0\na 399 400 5\n";
+    std::string path = writeGrFile("hrk_direct.gr", text);
+
+    haruki::RepeatedEdges policies[] = {haruki::KEEP_ALL_REPEATED, haruki::KEEP_FIRST_REPEATED, haruki::KEEP_MIN_COST_REPEATED};
+    for (int i = 0; i < 3; i++) {
+        haruki::Graph *mapped = haruki::dimacs::readGrFileMapped(path, 1, policies[i]);
+        for (int threads = 1; threads <= 4; threads += 3) {
+            haruki::Graph *direct = haruki::dimacs::readGrFileDirect(path, threads, policies[i]);
+            ASSERT_NO_FATAL_FAILURE(expectSameGraph(*mapped, *direct));
+            delete direct;
+        }
+        delete mapped;
+    }
+    std::remove(path.c_str());
+}
+
+TEST(DIMACS, DIRECT_LOAD_WITHOUT_HEADER) {
+    /* no 'p' line, then one that is too small: both read through the builder */
+    const char *texts[] = {"a 1 2 3\na 2 3 1\na 1 2 5\n", "p sp 2 3\na 1 2 3\na 2 3 1\na 1 2 5\n"};
+    for (int i = 0; i < 2; i++) {
+        std::string path = writeGrFile("hrk_noheader.gr", texts[i]);
+        haruki::Graph *direct = haruki::dimacs::readGrFileDirect(path);
+        std::remove(path.c_str());
+        ASSERT_EQ(3, direct->getNumVert());
+        ASSERT_EQ(2, direct->getNumEdges());
+        ASSERT_DOUBLE_EQ(3, direct->getEdgeCost(0, 1));
+        delete direct;
+    }
+    ASSERT_EQ(nullptr, haruki::dimacs::readGrFileDirect(::testing::TempDir() + "hrk_missing.gr"));
+}
+
+TEST(DIMACS, TOO_MANY_VERTICES) {
+    const char *texts[] = {"p sp 3000000000 2\na 1 2 3\na 2 1 1\n", "a 1 3000000000 3\n"};
+    for (int i = 0; i < 2; i++) {
+        std::string path = writeGrFile("hrk_huge.gr", texts[i]);
+        haruki::GraphBuilder pg;
+        ASSERT_FALSE(haruki::dimacs::readGrFileMapped(path, pg));
+        ASSERT_EQ(nullptr, haruki::dimacs::readGrFileDirect(path));
+        std::remove(path.c_str());
+    }
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2018 Diogo Haruki Kykuta
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+*/
+#include <gtest/gtest.h>
+#include "../src/edgemask.hpp"
+
+TEST(EDGE_MASK, DEFAULT_FLAG) {
+    haruki::EdgeMask m1(5, false);
+    haruki::EdgeMask m2(5, true);
+
+    for (int i = 0; i < 5; i++) {
+        ASSERT_FALSE(m1[i]);
+        ASSERT_TRUE(m2[i]);
+    }
+    ASSERT_EQ(5, m1.size());
+}
+
+TEST(EDGE_MASK, SET_AND_GET) {
+    haruki::EdgeMask m(5, false);
+
+    m.set(1, true);
+    m.set(3, true);
+    ASSERT_FALSE(m[0]);
+    ASSERT_TRUE(m[1]);
+    ASSERT_FALSE(m[2]);
+    ASSERT_TRUE(m[3]);
+
+    m.set(3, false);
+    ASSERT_FALSE(m[3]);
+}
+
+TEST(EDGE_MASK, SET_ALL_FORGETS_PREVIOUS_WRITES) {
+    haruki::EdgeMask m(5, false);
+
+    m.set(1, true);
+    m.set(2, true);
+    m.setAll(false);
+    for (int i = 0; i < 5; i++) {
+        ASSERT_FALSE(m[i]);
+    }
+
+    m.set(4, false);
+    m.setAll(true);
+    for (int i = 0; i < 5; i++) {
+        ASSERT_TRUE(m[i]);
+    }
+
+    m.set(0, false);
+    ASSERT_FALSE(m[0]);
+    ASSERT_TRUE(m[1]);
+}
+
+TEST(EDGE_MASK, EPOCH_WRAP_AROUND) {
+    haruki::EdgeMask m(3, false);
+
+    m.set(1, true);
+    m.epoch_ = ~0u - 1;
+    m.set(2, true);
+    m.setAll(false);
+    ASSERT_FALSE(m[0]);
+    ASSERT_FALSE(m[1]);
+    ASSERT_FALSE(m[2]);
+
+    m.set(0, true);
+    ASSERT_TRUE(m[0]);
+    ASSERT_FALSE(m[2]);
+}
+
+TEST(EDGE_MASK, NEXT_ENABLED_SKIPS_WORDS) {
+    haruki::EdgeMask m(300, true);
+
+    ASSERT_EQ(300, m.nextEnabled(0, 300));
+    ASSERT_EQ(10, m.nextEnabled(10, 10));
+
+    m.set(5, false);
+    m.set(130, false);
+    m.set(299, false);
+    ASSERT_EQ(5, m.nextEnabled(0, 300));
+    ASSERT_EQ(5, m.nextEnabled(5, 300));
+    ASSERT_EQ(130, m.nextEnabled(6, 300));
+    ASSERT_EQ(100, m.nextEnabled(6, 100));
+    ASSERT_EQ(299, m.nextEnabled(131, 300));
+    ASSERT_EQ(298, m.nextEnabled(131, 298));
+
+    m.setAll(false);
+    m.set(64, true);
+    m.set(65, true);
+    ASSERT_EQ(63, m.nextEnabled(63, 300));
+    ASSERT_EQ(66, m.nextEnabled(64, 300));
+}
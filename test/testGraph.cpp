@@ -303,3 +303,663 @@ TEST(GRAPH, GET_EDGES_IN_ITER_REMOVE_ARTIFICIAL_FENG) {
     ++x4;
     ASSERT_FALSE(it4.end() != x4);
 }
+
+TEST(GRAPH, RESET_EDGES_REMOVED) {
+    haruki::GraphBuilder pg1;
+    pg1.addEdge(0, 1, 1.1);
+    pg1.addEdge(0, 2, 1.2);
+    pg1.addEdge(1, 2, 1.3);
+
+    haruki::Graph g1(pg1);
+
+    g1.setAllEdgesRemoved();
+    ASSERT_TRUE(g1.isRemoved(0, 1));
+    ASSERT_TRUE(g1.isRemoved(1, 2));
+
+    g1.setRemovedEdgeFlag(0, 2, EDGE_ENABLED);
+    ASSERT_FALSE(g1.isRemoved(0, 2));
+
+    g1.resetEdgesRemoved();
+    g1.removeEdge(0, 1);
+    ASSERT_TRUE(g1.isRemoved(0, 1));
+    ASSERT_FALSE(g1.isRemoved(0, 2));
+    ASSERT_FALSE(g1.isRemoved(1, 2));
+
+    g1.resetEdgesRemoved();
+    ASSERT_FALSE(g1.isRemoved(0, 1));
+
+    haruki::EdgeList::range all = g1.getAllEdges();
+    int count = 0;
+    for (haruki::EdgeList::iterator it = all.begin(); it != all.end(); ++it) {
+        count++;
+    }
+    ASSERT_EQ(3, count);
+}
+
+TEST(GRAPH, COPY_SHARES_TOPOLOGY) {
+    haruki::GraphBuilder pg1;
+    pg1.addEdge(0, 1, 1.1);
+    pg1.addEdge(0, 2, 1.2);
+    pg1.addEdge(1, 2, 1.3);
+
+    haruki::Graph g1(pg1);
+    haruki::Graph g2(g1);
+    haruki::Graph g3(g1.getTopology());
+
+    ASSERT_EQ(g1.getTopology(), g2.getTopology());
+    ASSERT_EQ(g1.getTopology(), g3.getTopology());
+    ASSERT_TRUE(g2.costs_ == nullptr);
+    ASSERT_EQ(g1.edgesRemoved_, g2.edgesRemoved_);
+
+    g2.removeEdge(0, 1);
+    g2.setEdgeCost(2, 5.0);
+
+    ASSERT_FALSE(g1.isRemoved(0, 1));
+    ASSERT_TRUE(g2.isRemoved(0, 1));
+    ASSERT_DOUBLE_EQ(1.3, g1.getEdgeCost(1, 2));
+    ASSERT_DOUBLE_EQ(5.0, g2.getEdgeCost(1, 2));
+    ASSERT_DOUBLE_EQ(1.3, g3.getEdgeCost(1, 2));
+    ASSERT_DOUBLE_EQ(1.2, g2.getEdgeCost(0, 2));
+
+    /* only the parts written to are cloned */
+    ASSERT_NE(g1.edgesRemoved_, g2.edgesRemoved_);
+    haruki::Graph g4(g2);
+    ASSERT_EQ(g2.costs_, g4.costs_);
+    g4.setEdgeCost(2, 6.0);
+    ASSERT_NE(g2.costs_, g4.costs_);
+    ASSERT_DOUBLE_EQ(5.0, g2.getEdgeCost(1, 2));
+    ASSERT_DOUBLE_EQ(6.0, g4.getEdgeCost(1, 2));
+    ASSERT_TRUE(g4.isRemoved(0, 1));
+}
+
+TEST(GRAPH, EDGE_INDEX_LOOKUP) {
+    haruki::GraphBuilder pg1;
+    pg1.setNumVert(10);
+    for (int i = 0; i < 10; i++) {
+        for (int j = 0; j < 10; j += 1 + i % 3) {
+            pg1.addEdge(i, j, i * 10 + j);
+        }
+    }
+
+    haruki::Graph g1(pg1);
+    haruki::Graph g2(g1);
+    g2.buildEdgeIndex(0.9);
+    ASSERT_TRUE(g2.hasEdgeIndex());
+    ASSERT_FALSE(g1.hasEdgeIndex());
+
+    for (int i = 0; i < 10; i++) {
+        for (int j = 0; j < 10; j++) {
+            ASSERT_EQ(g1.getEdgeIndex(i, j), g2.getEdgeIndex(i, j));
+        }
+    }
+
+    g2.removeEdge(4, 8);
+    ASSERT_TRUE(g2.isRemoved(4, 8));
+    ASSERT_TRUE(g2.isRemoved(4, 7));
+    ASSERT_DOUBLE_EQ(-1.0, g2.getEdgeCost(4, 8));
+    ASSERT_DOUBLE_EQ(46.0, g2.getEdgeCost(4, 6));
+}
+
+TEST(GRAPH, EDGE_INDEX_MISSING_KEY_AT_HIGH_LOAD) {
+    /* 16 edges: a table of exactly 16 slots would have no empty one */
+    haruki::GraphBuilder pg;
+    pg.setNumVert(4);
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            pg.addEdge(i, j, i * 4 + j);
+        }
+    }
+    haruki::Graph g(pg);
+
+    double loadFactors[] = {0.999, 1, 2, 0, -1};
+    for (double loadFactor : loadFactors) {
+        haruki::EdgeIndex index(*g.getTopology(), loadFactor);
+        ASSERT_EQ(-1, index.find(0, 4));
+        ASSERT_EQ(-1, index.find(7, 7));
+        ASSERT_EQ(g.getEdgeIndex(2, 3), index.find(2, 3));
+    }
+    ASSERT_FALSE(haruki::EdgeIndex::isValidLoadFactor(1));
+    ASSERT_FALSE(haruki::EdgeIndex::isValidLoadFactor(0));
+    ASSERT_TRUE(haruki::EdgeIndex::isValidLoadFactor(0.999));
+}
+
+static_assert(sizeof(haruki::Span<const haruki::EdgeIdx>().size()) >= sizeof(haruki::EdgeIdx),
+              "Span sizes have to hold any edge count");
+
+TEST(GRAPH, SPAN_ACCESSORS_DO_NOT_COPY) {
+    haruki::GraphBuilder pg1;
+    pg1.addEdge(0, 2, 1.1);
+    pg1.addEdge(0, 1, 1.2);
+    pg1.addEdge(1, 2, 1.3);
+
+    haruki::Graph g1(pg1);
+
+    haruki::Span<const int> heads = g1.getHeads();
+    ASSERT_EQ(g1.getTopology()->heads.data(), heads.data());
+    ASSERT_EQ(3, heads.size());
+    ASSERT_EQ(1, heads[0]);
+    ASSERT_EQ(2, heads[1]);
+    ASSERT_EQ(2, heads[2]);
+
+    haruki::Span<const int> reverseTails = g1.getReverseTails();
+    ASSERT_EQ(0, reverseTails[0]);
+    ASSERT_EQ(0, reverseTails[1]);
+    ASSERT_EQ(1, reverseTails[2]);
+
+    g1.setEdgeCost(1, 7.0);
+    haruki::Span<const haruki::Weight> costs = g1.getCosts();
+    ASSERT_DOUBLE_EQ(1.2, costs[0]);
+    ASSERT_DOUBLE_EQ(7.0, costs[1]);
+}
+
+TEST(GRAPH, REVERSE_INDEX_IS_LAZY) {
+    haruki::GraphBuilder pg1;
+    pg1.addEdge(0, 3, 1.1);
+    pg1.addEdge(2, 3, 1.2);
+    pg1.addEdge(1, 3, 1.3);
+    pg1.addEdge(3, 0, 1.4);
+
+    haruki::Graph g1(pg1);
+    haruki::Graph g2(g1);
+    ASSERT_TRUE(g1.getTopology()->reverseTrace.empty());
+
+    haruki::EdgeIn::range it = g1.getEdgesIn(3);
+    haruki::EdgeIn::iterator x = it.begin();
+    ASSERT_EQ(0, (*x).tail);
+    ++x;
+    ASSERT_EQ(1, (*x).tail);
+    ASSERT_DOUBLE_EQ(1.3, (*x).cost);
+    ++x;
+    ASSERT_EQ(2, (*x).tail);
+    ++x;
+    ASSERT_FALSE(it.end() != x);
+
+    /* built once for every graph sharing the topology */
+    ASSERT_EQ(4, g2.getReverseTrace().size());
+    ASSERT_EQ(g1.getReverseTrace().data(), g2.getReverseTrace().data());
+}
+
+TEST(GRAPH, PARALLEL_BUILD_MATCHES_SERIAL) {
+    haruki::GraphBuilder pg1;
+    pg1.setNumVert(5000);
+    unsigned int seed = 7;
+    for (int i = 0; i < 100000; i++) {
+        seed = seed * 1103515245 + 12345;
+        int tail = (seed >> 8) % 5000;
+        seed = seed * 1103515245 + 12345;
+        int head = (seed >> 8) % 5000;
+        pg1.addEdge(tail, head, i);
+    }
+
+    haruki::Graph serial(pg1, 1);
+    haruki::Graph parallel(pg1, 4);
+
+    ASSERT_EQ(serial.getNumEdges(), parallel.getNumEdges());
+    for (int v = 0; v < serial.getNumVert(); v++) {
+        ASSERT_EQ(serial.getFirstEdgeEachV()[v], parallel.getFirstEdgeEachV()[v]);
+    }
+    for (int idx = 0; idx < serial.getNumEdges(); idx++) {
+        ASSERT_EQ(serial.getHeads()[idx], parallel.getHeads()[idx]);
+        ASSERT_DOUBLE_EQ(serial.getCosts()[idx], parallel.getCosts()[idx]);
+        if (idx > 0 && serial.getHeads()[idx - 1] == serial.getHeads()[idx]) {
+            /* parallel edges keep the input order */
+            ASSERT_LT(serial.getCosts()[idx - 1], serial.getCosts()[idx]);
+        }
+    }
+}
+
+TEST(GRAPH, COMPRESSED_MATCHES_PLAIN) {
+    /* costs fitting 1 byte codes, 2 byte codes and no dictionary at all */
+    int costRanges[] = {7, 1000, 100000};
+    for (int costRange : costRanges) {
+        haruki::GraphBuilder pg;
+        pg.setNumVert(5000);
+        unsigned int seed = 11;
+        for (int i = 0; i < 100000; i++) {
+            seed = seed * 1103515245 + 12345;
+            int tail = (seed >> 8) % 5000;
+            seed = seed * 1103515245 + 12345;
+            int head = (seed >> 8) % 5000;
+            pg.addEdge(tail, head, i % costRange);
+        }
+
+        haruki::Graph plain(pg);
+        haruki::Graph packed(pg);
+        packed.compress();
+        /* like the compressed lookup, the index answers with the first of
+         * parallel edges where binary search could pick any of them */
+        plain.buildEdgeIndex();
+        ASSERT_TRUE(packed.isCompressed());
+        ASSERT_FALSE(plain.isCompressed());
+        ASSERT_LT(packed.topologyBytes(), plain.topologyBytes());
+        ASSERT_EQ(costRange < 100000, packed.getTopology()->costs.empty());
+
+        for (int idx = 0; idx < plain.getNumEdges(); idx += 3) {
+            plain.setRemovedEdgeFlag(idx, EDGE_DISABLED);
+            packed.setRemovedEdgeFlag(idx, EDGE_DISABLED);
+        }
+
+        for (int v = 0; v < plain.getNumVert(); v++) {
+            haruki::EdgeOut::range expected = plain.getEdgesOut(v);
+            haruki::EdgeOut::range actual = packed.getEdgesOut(v);
+            haruki::EdgeOut::iterator it2 = actual.begin();
+            for (haruki::EdgeOut::iterator it = expected.begin(); it != expected.end(); ++it, ++it2) {
+                ASSERT_TRUE(it2 != actual.end());
+                ASSERT_EQ(it.getEdgeIdx(), it2.getEdgeIdx());
+                ASSERT_EQ(it.head(), it2.head());
+                ASSERT_DOUBLE_EQ(it.cost(), it2.cost());
+                ASSERT_DOUBLE_EQ(plain.getEdgeCost(v, it.head()), packed.getEdgeCost(v, it2.head()));
+            }
+            ASSERT_FALSE(it2 != actual.end());
+        }
+
+        std::vector<haruki::EdgeInfo> plainEdges = plain.getEdgeInfoList();
+        std::vector<haruki::EdgeInfo> packedEdges = packed.getEdgeInfoList();
+        ASSERT_TRUE(packed.getTopology()->heads.empty());
+        for (size_t idx = 0; idx < plainEdges.size(); idx++) {
+            ASSERT_EQ(plainEdges[idx].tail, packedEdges[idx].tail);
+            ASSERT_EQ(plainEdges[idx].head, packedEdges[idx].head);
+            ASSERT_DOUBLE_EQ(plainEdges[idx].cost, packedEdges[idx].cost);
+        }
+
+        /* cost overlays and random access decode the compressed arrays */
+        packed.setEdgeCost(1, 12345);
+        ASSERT_DOUBLE_EQ(12345, packed.getCosts()[1]);
+        ASSERT_DOUBLE_EQ(plain.getCosts()[2], packed.getCosts()[2]);
+        for (int idx = 0; idx < plain.getNumEdges(); idx++) {
+            ASSERT_EQ(plain.getHeads()[idx], packed.getHeads()[idx]);
+            ASSERT_EQ(plain.getReverseTrace()[idx], packed.getReverseTrace()[idx]);
+        }
+    }
+}
+
+TEST(GRAPH, UPDATE_EDGE_COSTS) {
+    haruki::GraphBuilder pg;
+    pg.setNumVert(4);
+    pg.addEdge(0, 1, 1);
+    pg.addEdge(0, 2, 2);
+    pg.addEdge(1, 3, 3);
+    pg.addEdge(2, 3, 4);
+
+    haruki::Graph g(pg);
+    ASSERT_EQ(0, g.getCostVersion());
+
+    /* a copy taken before the update keeps the old costs */
+    haruki::Graph *snapshot = new haruki::Graph(g);
+    std::vector<haruki::EdgeInfo> batch1;
+    batch1.push_back(haruki::EdgeInfo(0, 2, 7));
+    batch1.push_back(haruki::EdgeInfo(3, 0, 9));
+    ASSERT_EQ(1, g.updateEdgeCosts(batch1));
+    ASSERT_EQ(1, g.getCostVersion());
+    ASSERT_DOUBLE_EQ(7, g.getEdgeCost(0, 2));
+    ASSERT_DOUBLE_EQ(2, snapshot->getEdgeCost(0, 2));
+    ASSERT_NE(g.getTopology(), snapshot->getTopology());
+    delete snapshot;
+
+    /* with nobody else on the topology the costs are written in place */
+    const haruki::GraphTopology *topology = g.getTopology().get();
+    std::vector<haruki::EdgeInfo> batch2;
+    batch2.push_back(haruki::EdgeInfo(2, 3, 5));
+    batch2.push_back(haruki::EdgeInfo(0, 2, 6));
+    ASSERT_EQ(2, g.updateEdgeCosts(batch2));
+    ASSERT_EQ(topology, g.getTopology().get());
+    ASSERT_EQ(2, g.getCostVersion());
+    ASSERT_DOUBLE_EQ(6, g.getEdgeCost(0, 2));
+    ASSERT_DOUBLE_EQ(5, g.getEdgeCost(2, 3));
+
+    std::vector<haruki::EdgeIdx> edges;
+    ASSERT_TRUE(g.getDirtyEdges(0, edges));
+    ASSERT_EQ(2, edges.size());
+    ASSERT_EQ(1, edges[0]);
+    ASSERT_EQ(3, edges[1]);
+    ASSERT_TRUE(g.getDirtyEdges(1, edges));
+    ASSERT_EQ(2, edges.size());
+    ASSERT_TRUE(g.getDirtyEdges(2, edges));
+    ASSERT_EQ(0, edges.size());
+
+    g.clearDirtyEdges();
+    ASSERT_FALSE(g.getDirtyEdges(1, edges));
+    ASSERT_TRUE(g.getDirtyEdges(2, edges));
+    ASSERT_EQ(0, edges.size());
+
+    /* dictionary coded costs are decoded before the first update */
+    g.compress();
+    std::vector<haruki::EdgeInfo> batch3;
+    batch3.push_back(haruki::EdgeInfo(1, 3, 11));
+    ASSERT_EQ(1, g.updateEdgeCosts(batch3));
+    ASSERT_DOUBLE_EQ(11, g.getEdgeCost(1, 3));
+    haruki::EdgeOut::range out = g.getEdgesOut(1);
+    ASSERT_DOUBLE_EQ(11, out.begin().cost());
+    ASSERT_TRUE(g.getDirtyEdges(2, edges));
+    ASSERT_EQ(1, edges.size());
+    ASSERT_EQ(2, edges[0]);
+}
+
+TEST(GRAPH, DIRTY_LOG_IS_CAPPED) {
+    haruki::GraphBuilder pg;
+    pg.setNumVert(3);
+    pg.addEdge(0, 1, 1);
+    pg.addEdge(1, 2, 1);
+    haruki::Graph g(pg);
+
+    /* far more entries than the log keeps for such a small graph */
+    std::vector<haruki::EdgeInfo> batch;
+    batch.push_back(haruki::EdgeInfo(0, 1, 2));
+    batch.push_back(haruki::EdgeInfo(1, 2, 2));
+    for (int i = 0; i < 5000; i++) {
+        g.updateEdgeCosts(batch);
+    }
+    ASSERT_EQ(5000, g.getCostVersion());
+    std::vector<haruki::EdgeIdx> edges;
+    ASSERT_LE(g.dirtyLog_->edges.size(), 4096);
+    ASSERT_EQ(g.dirtyLog_->edges.size(), 2 * g.dirtyLog_->batches.size());
+
+    /* copies share the log until one of them writes to it */
+    haruki::Graph copy(g);
+    ASSERT_EQ(g.dirtyLog_, copy.dirtyLog_);
+    copy.updateEdgeCosts(batch);
+    ASSERT_NE(g.dirtyLog_, copy.dirtyLog_);
+    ASSERT_TRUE(copy.getDirtyEdges(5000, edges));
+    ASSERT_EQ(2, edges.size());
+
+    ASSERT_FALSE(g.getDirtyEdges(0, edges));
+    ASSERT_EQ(0, edges.size());
+    ASSERT_FALSE(g.getDirtyEdges(g.dirtyLogStart_ - 1, edges));
+    ASSERT_TRUE(g.getDirtyEdges(g.dirtyLogStart_, edges));
+    ASSERT_EQ(2, edges.size());
+    ASSERT_TRUE(g.getDirtyEdges(4999, edges));
+    ASSERT_EQ(2, edges.size());
+    ASSERT_TRUE(g.getDirtyEdges(5000, edges));
+    ASSERT_EQ(0, edges.size());
+}
+
+TEST(GRAPH, DELTA_OVERLAY) {
+    haruki::GraphBuilder pg;
+    pg.setNumVert(4);
+    pg.addEdge(0, 1, 1);
+    pg.addEdge(0, 2, 2);
+    pg.addEdge(1, 3, 3);
+    pg.addEdge(2, 3, 4);
+
+    haruki::Graph g(pg);
+    haruki::Graph *snapshot = new haruki::Graph(g);
+
+    std::vector<haruki::EdgeInfo> inserted;
+    inserted.push_back(haruki::EdgeInfo(0, 3, 8));
+    inserted.push_back(haruki::EdgeInfo(3, 0, 9));
+    inserted.push_back(haruki::EdgeInfo(3, 7, 1));
+    ASSERT_EQ(2, g.insertEdges(inserted));
+    ASSERT_EQ(6, g.getNumEdges());
+    ASSERT_EQ(4, g.getTopology()->numEdges);
+    ASSERT_DOUBLE_EQ(8, g.getEdgeCost(0, 3));
+
+    std::vector<haruki::EdgeInfo> deleted;
+    deleted.push_back(haruki::EdgeInfo(0, 2, 0));
+    deleted.push_back(haruki::EdgeInfo(3, 0, 0));
+    deleted.push_back(haruki::EdgeInfo(2, 0, 0));
+    ASSERT_EQ(2, g.deleteEdges(deleted));
+    ASSERT_EQ(4, g.getDeltaSize());
+    ASSERT_DOUBLE_EQ(-1, g.getEdgeCost(0, 2));
+    ASSERT_DOUBLE_EQ(-1, g.getEdgeCost(3, 0));
+
+    /* the overlay follows the CSR edges of each vertex */
+    std::vector<haruki::EdgeInfo> out = g.getEdgesByTail(0);
+    ASSERT_EQ(2, out.size());
+    ASSERT_EQ(1, out[0].head);
+    ASSERT_EQ(3, out[1].head);
+    ASSERT_DOUBLE_EQ(8, out[1].cost);
+    ASSERT_EQ(0, g.getEdgesByTail(3).size());
+
+    std::vector<int> tails;
+    haruki::EdgeIn::range in = g.getEdgesIn(3);
+    for (auto it = in.begin(); it != in.end(); ++it) {
+        tails.push_back(it.tail());
+    }
+    ASSERT_EQ(3, tails.size());
+    ASSERT_EQ(1, tails[0]);
+    ASSERT_EQ(2, tails[1]);
+    ASSERT_EQ(0, tails[2]);
+
+    int numAll = 0;
+    haruki::EdgeList::range all = g.getAllEdges();
+    for (auto it = all.begin(); it != all.end(); ++it) {
+        numAll++;
+    }
+    ASSERT_EQ(4, numAll);
+    ASSERT_EQ(4, g.getEdgeInfoList().size());
+
+    /* removal flags work on inserted edges, tombstones survive resets */
+    g.removeEdge(0, 3);
+    ASSERT_TRUE(g.isRemoved(0, 3));
+    g.resetEdgesRemoved();
+    ASSERT_FALSE(g.isRemoved(0, 3));
+    ASSERT_TRUE(g.isRemoved(0, 2));
+    g.setRemovedForOutgoingEdges(0, EDGE_DISABLED);
+    ASSERT_EQ(0, g.getEdgesByTail(0).size());
+    g.setRemovedForOutgoingEdges(0, EDGE_ENABLED);
+    ASSERT_EQ(2, g.getEdgesByTail(0).size());
+
+    /* costs of inserted edges can be updated and rewritten */
+    std::vector<haruki::EdgeInfo> updates;
+    updates.push_back(haruki::EdgeInfo(0, 3, 6));
+    ASSERT_EQ(1, g.updateEdgeCosts(updates));
+    ASSERT_DOUBLE_EQ(6, g.getEdgeCost(0, 3));
+    haruki::Graph h(g);
+    h.setEdgeCost(4, 5);
+    ASSERT_DOUBLE_EQ(5, h.getEdgeCost(0, 3));
+    ASSERT_DOUBLE_EQ(6, g.getEdgeCost(0, 3));
+
+    /* copies taken before the changes do not see them */
+    ASSERT_EQ(4, snapshot->getNumEdges());
+    ASSERT_DOUBLE_EQ(2, snapshot->getEdgeCost(0, 2));
+    ASSERT_DOUBLE_EQ(-1, snapshot->getEdgeCost(0, 3));
+    ASSERT_FALSE(snapshot->hasDelta());
+    delete snapshot;
+}
+
+TEST(GRAPH, DELTA_COMPACTION) {
+    haruki::GraphBuilder pg;
+    for (int v = 0; v < 100; v++) {
+        pg.addEdge(v, (v + 1) % 100, v);
+        pg.addEdge(v, (v + 7) % 100, 2 * v);
+    }
+
+    haruki::Graph g(pg);
+    g.compress();
+    std::vector<haruki::EdgeInfo> inserted, deleted;
+    for (int v = 0; v < 100; v += 3) {
+        inserted.push_back(haruki::EdgeInfo(v, (v + 50) % 100, 1));
+        deleted.push_back(haruki::EdgeInfo(v, (v + 7) % 100, 0));
+    }
+    g.insertEdges(inserted);
+    g.deleteEdges(deleted);
+
+    std::vector<haruki::EdgeInfo> before = g.getEdgeInfoList();
+    std::sort(before.begin(), before.end());
+    g.compactDelta();
+    ASSERT_FALSE(g.hasDelta());
+    ASSERT_TRUE(g.isCompressed());
+    ASSERT_EQ(before.size(), g.getNumEdges());
+    std::vector<haruki::EdgeInfo> after = g.getEdgeInfoList();
+    std::sort(after.begin(), after.end());
+    for (size_t i = 0; i < before.size(); i++) {
+        ASSERT_EQ(before[i].tail, after[i].tail);
+        ASSERT_EQ(before[i].head, after[i].head);
+        ASSERT_DOUBLE_EQ(before[i].cost, after[i].cost);
+    }
+
+    /* past the threshold a compaction runs in the background, changes made
+     * meanwhile are replayed on top of it */
+    g.setCompactionThreshold(0.1, 1);
+    std::vector<haruki::EdgeInfo> more;
+    for (int v = 1; v < 100; v += 3) {
+        more.push_back(haruki::EdgeInfo(v, (v + 30) % 100, 3));
+    }
+    g.insertEdges(more);
+    ASSERT_TRUE(g.isCompacting());
+    std::vector<haruki::EdgeInfo> late;
+    late.push_back(haruki::EdgeInfo(2, 40, 4));
+    g.insertEdges(late);
+    g.waitCompaction();
+    ASSERT_FALSE(g.isCompacting());
+    ASSERT_EQ(1, g.getDeltaSize());
+    ASSERT_EQ(before.size() + more.size() + 1, g.getNumEdges());
+    ASSERT_DOUBLE_EQ(3, g.getEdgeCost(1, 31));
+    ASSERT_DOUBLE_EQ(4, g.getEdgeCost(2, 40));
+}
+
+TEST(GRAPH, DISABLE_VERTEX) {
+    haruki::GraphBuilder pg;
+    pg.setNumVert(4);
+    pg.addEdge(0, 1, 1);
+    pg.addEdge(1, 2, 2);
+    pg.addEdge(1, 3, 3);
+    pg.addEdge(2, 3, 4);
+    pg.addEdge(3, 1, 5);
+
+    haruki::Graph g(pg);
+    g.disableVertex(1);
+    ASSERT_TRUE(g.isVertexDisabled(1));
+    ASSERT_FALSE(g.isVertexDisabled(2));
+
+    /* edges out of 1 are gone, edges into it are kept */
+    ASSERT_TRUE(g.isRemoved(1, 2));
+    ASSERT_TRUE(g.isRemoved(1, 3));
+    ASSERT_FALSE(g.isRemoved(0, 1));
+    ASSERT_DOUBLE_EQ(-1, g.getEdgeCost(1, 2));
+    ASSERT_FALSE(g.getEdgesOut(1).begin() != g.getEdgesOut(1).end());
+    int in3 = 0;
+    for (haruki::EdgeIn::iterator it = g.getEdgesIn(3).begin(); it != g.getEdgesIn(3).end(); ++it) {
+        ASSERT_EQ(2, (*it).tail);
+        in3++;
+    }
+    ASSERT_EQ(1, in3);
+    int all = 0;
+    for (haruki::EdgeList::iterator it = g.getAllEdges().begin(); it != g.getAllEdges().end(); ++it) {
+        ASSERT_NE(1, (*it).tail);
+        all++;
+    }
+    ASSERT_EQ(3, all);
+    /* by index too: edges 1 and 2 leave 1 */
+    ASSERT_FALSE(g.isRemoved((haruki::EdgeIdx)0));
+    ASSERT_TRUE(g.isRemoved((haruki::EdgeIdx)1));
+    ASSERT_TRUE(g.isRemoved((haruki::EdgeIdx)2));
+    ASSERT_FALSE(g.isRemoved((haruki::EdgeIdx)3));
+    ASSERT_FALSE(g.isRemoved((haruki::EdgeIdx)4));
+
+    /* the flags of the edges themselves are untouched */
+    g.removeEdge(2, 3);
+    g.resetEdgesRemoved();
+    ASSERT_FALSE(g.isVertexDisabled(1));
+    ASSERT_FALSE(g.isRemoved(1, 2));
+    ASSERT_FALSE(g.isRemoved((haruki::EdgeIdx)1));
+    ASSERT_FALSE(g.isRemoved(2, 3));
+    ASSERT_DOUBLE_EQ(2, g.getEdgeCost(1, 2));
+}
+
+TEST(GRAPH, ISOLATE_VERTEX) {
+    haruki::GraphBuilder pg;
+    pg.setNumVert(4);
+    pg.addEdge(0, 1, 1);
+    pg.addEdge(1, 2, 2);
+    pg.addEdge(1, 3, 3);
+    pg.addEdge(2, 3, 4);
+    pg.addEdge(3, 1, 5);
+
+    haruki::Graph g(pg);
+    std::vector<haruki::EdgeInfo> inserted;
+    inserted.push_back(haruki::EdgeInfo(2, 1, 6));
+    g.insertEdges(inserted);
+    haruki::Graph copy(g);
+    g.isolateVertex(1);
+    ASSERT_TRUE(g.isVertexIsolated(1));
+    ASSERT_TRUE(g.isVertexDisabled(1));
+    ASSERT_FALSE(copy.isVertexIsolated(1));
+
+    /* edges on both sides of 1 are gone, inserted ones included */
+    ASSERT_TRUE(g.isRemoved(0, 1));
+    ASSERT_TRUE(g.isRemoved(3, 1));
+    ASSERT_TRUE(g.isRemoved(2, 1));
+    ASSERT_TRUE(g.isRemoved(1, 2));
+    ASSERT_FALSE(g.isRemoved(2, 3));
+    ASSERT_DOUBLE_EQ(-1, g.getEdgeCost(0, 1));
+    ASSERT_TRUE(g.isRemoved((haruki::EdgeIdx)0));
+    ASSERT_TRUE(g.isRemoved((haruki::EdgeIdx)4));
+    ASSERT_TRUE(g.isRemoved((haruki::EdgeIdx)5));
+    ASSERT_FALSE(g.isRemoved((haruki::EdgeIdx)3));
+    ASSERT_FALSE(g.getEdgesIn(1).begin() != g.getEdgesIn(1).end());
+    ASSERT_FALSE(g.getEdgesOut(0).begin() != g.getEdgesOut(0).end());
+    int out2 = 0;
+    for (haruki::EdgeOut::iterator it = g.getEdgesOut(2).begin(); it != g.getEdgesOut(2).end(); ++it) {
+        ASSERT_EQ(3, (*it).head);
+        out2++;
+    }
+    ASSERT_EQ(1, out2);
+    int all = 0;
+    for (haruki::EdgeList::iterator it = g.getAllEdges().begin(); it != g.getAllEdges().end(); ++it) {
+        ASSERT_NE(1, (*it).tail);
+        ASSERT_NE(1, (*it).head);
+        all++;
+    }
+    ASSERT_EQ(1, all);
+
+    /* the copy taken before keeps every edge */
+    ASSERT_FALSE(copy.isRemoved(0, 1));
+    ASSERT_DOUBLE_EQ(6, copy.getEdgeCost(2, 1));
+
+    g.resetEdgesRemoved();
+    ASSERT_FALSE(g.isVertexIsolated(1));
+    ASSERT_FALSE(g.isRemoved(0, 1));
+    ASSERT_FALSE(g.isRemoved((haruki::EdgeIdx)5));
+}
+
+TEST(GRAPH, SYMMETRIC_STORAGE) {
+    haruki::GraphBuilder pg;
+    pg.setNumVert(4);
+    pg.addEdge(0, 1, 1);
+    pg.addEdge(1, 0, 2);
+    pg.addEdge(0, 2, 3);
+    pg.addEdge(2, 0, 3);
+    pg.addEdge(1, 2, 4);
+    pg.addEdge(2, 1, 5);
+    pg.addEdge(2, 3, 6);
+    pg.addEdge(3, 2, 7);
+
+    haruki::Graph plain(pg);
+    plain.buildReverseIndex();
+    haruki::Graph g(pg);
+    ASSERT_TRUE(g.useSymmetricStorage());
+    ASSERT_TRUE(g.isSymmetric());
+    ASSERT_TRUE(g.getTopology()->reverseTrace.empty());
+    ASSERT_LT(g.topologyBytes(), plain.topologyBytes());
+
+    /* each direction keeps its own cost and removal flag */
+    g.removeEdge(1, 2);
+    plain.removeEdge(1, 2);
+    for (int v = 0; v < 4; v++) {
+        std::vector<haruki::EdgeInfo> expected, result;
+        for (haruki::EdgeIn::iterator it = plain.getEdgesIn(v).begin(); it != plain.getEdgesIn(v).end(); ++it) {
+            expected.push_back(*it);
+        }
+        for (haruki::EdgeIn::iterator it = g.getEdgesIn(v).begin(); it != g.getEdgesIn(v).end(); ++it) {
+            ASSERT_EQ(g.getEdgeIndex((*it).tail, v), it.getEdgeIdx());
+            result.push_back(*it);
+        }
+        ASSERT_EQ(expected.size(), result.size());
+        for (size_t i = 0; i < expected.size(); i++) {
+            ASSERT_EQ(expected[i].tail, result[i].tail);
+            ASSERT_DOUBLE_EQ(expected[i].cost, result[i].cost);
+        }
+    }
+    ASSERT_FALSE(g.isRemoved(2, 1));
+
+    g.setRemovedForIncomingEdges(2, true);
+    ASSERT_TRUE(g.isRemoved(0, 2));
+    ASSERT_TRUE(g.isRemoved(3, 2));
+    ASSERT_FALSE(g.isRemoved(2, 0));
+
+    pg.addEdge(3, 0, 1);
+    haruki::Graph oneWay(pg);
+    ASSERT_FALSE(oneWay.useSymmetricStorage());
+    ASSERT_FALSE(oneWay.isSymmetric());
+}
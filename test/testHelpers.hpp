@@ -0,0 +1,36 @@
+/*
+ * Copyright (C) 2018 Diogo Haruki Kykuta
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "../src/path.hpp"
+
+/* the same paths in the same order, for algorithms run on a graph and on a
+ * copy of it rebuilt some other way; wrap in ASSERT_NO_FATAL_FAILURE */
+static void assertSamePaths(const std::vector<haruki::Path> &expected, const std::vector<haruki::Path> &result) {
+    ASSERT_EQ(expected.size(), result.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        ASSERT_DOUBLE_EQ(expected[i].cost(), result[i].cost());
+        ASSERT_EQ(expected[i].getVertList(), result[i].getVertList());
+    }
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2018 Diogo Haruki Kykuta
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+*/
+#include <gtest/gtest.h>
+#include <cstdint>
+#include "../src/hugepage.hpp"
+#include "../src/graph.hpp"
+
+TEST(HUGEPAGE, PARSE_MODE) {
+    haruki::hugepage::Mode mode;
+    ASSERT_TRUE(haruki::hugepage::parseMode("thp", mode));
+    ASSERT_EQ(haruki::hugepage::TRANSPARENT, mode);
+    ASSERT_TRUE(haruki::hugepage::parseMode("off", mode));
+    ASSERT_EQ(haruki::hugepage::SMALL, mode);
+    ASSERT_FALSE(haruki::hugepage::parseMode("huge", mode));
+    ASSERT_EQ(haruki::hugepage::SMALL, mode);
+}
+
+TEST(HUGEPAGE, ALIGNMENT_AND_GROWTH) {
+    const char *modes[] = {"off", "system", "thp", "hugetlb"};
+    for (int m = 0; m < 4; m++) {
+        haruki::hugepage::Mode mode;
+        ASSERT_TRUE(haruki::hugepage::parseMode(modes[m], mode));
+        haruki::hugepage::setMode(mode);
+
+        haruki::HugeVector<int> small(10, 7);
+        ASSERT_EQ(0, (uintptr_t)small.data() % haruki::hugepage::kCacheLineBytes);
+
+        /* grows past the huge page size, moving from the heap to a mapping */
+        haruki::HugeVector<int> v;
+        for (int i = 0; i < (1 << 20); i++) {
+            v.push_back(i);
+        }
+        ASSERT_EQ(0, (uintptr_t)v.data() % haruki::hugepage::kHugePageBytes);
+        for (int i = 0; i < (1 << 20); i += 4099) {
+            ASSERT_EQ(i, v[i]);
+        }
+
+        /* released under another mode than the one it was allocated with */
+        haruki::hugepage::setMode(haruki::hugepage::SYSTEM);
+    }
+}
+
+TEST(HUGEPAGE, GRAPH_WITH_TRANSPARENT_PAGES) {
+    haruki::hugepage::setMode(haruki::hugepage::TRANSPARENT);
+    haruki::GraphBuilder pg;
+    for (int v = 0; v < 1000; v++) {
+        pg.addEdge(v, (v + 1) % 1000, 1);
+        pg.addEdge(v, (v + 10) % 1000, 5);
+    }
+    haruki::Graph g(pg);
+    haruki::hugepage::setMode(haruki::hugepage::SYSTEM);
+    ASSERT_DOUBLE_EQ(5, g.getEdgeCost(3, 13));
+    ASSERT_EQ(0, (uintptr_t)g.getHeads().data() % haruki::hugepage::kCacheLineBytes);
+}
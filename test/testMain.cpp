@@ -24,6 +24,7 @@
 #define protected public
 
 #include "testGraph.cpp"
+#include "testEdgeMask.cpp"
 #include "testPath.cpp"
 #include "testDijkstra.cpp"
 #include "testPriorityQueue.cpp"
@@ -34,6 +35,12 @@
 #include "testPascoalKSP.cpp"
 #include "testFengKSP.cpp"
 #include "testHybridKSP.cpp"
+#include "testReorder.cpp"
+#include "testHugePage.cpp"
+#include "testTrim.cpp"
+#include "testContract.cpp"
+#include "testDimacsReader.cpp"
+#include "testSnapshot.cpp"
 
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2018 Diogo Haruki Kykuta
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+*/
+#include <gtest/gtest.h>
+#include <algorithm>
+#include "../src/reorder.hpp"
+#include "../src/yenksp.hpp"
+#include "../src/ksp.hpp"
+#include "../src/path.hpp"
+#include "../src/graph.hpp"
+#include "testHelpers.hpp"
+
+static haruki::GraphBuilder reorderTestGraph() {
+    haruki::GraphBuilder pg;
+    pg.setNumVert(7);
+    pg.addEdge(0, 1, 1);
+    pg.addEdge(0, 2, 2);
+    pg.addEdge(1, 3, 2);
+    pg.addEdge(1, 4, 2);
+    pg.addEdge(1, 5, 1);
+    pg.addEdge(2, 1, 2);
+    pg.addEdge(2, 4, 2);
+    pg.addEdge(3, 2, 2);
+    pg.addEdge(3, 6, 2);
+    pg.addEdge(4, 6, 2);
+    pg.addEdge(5, 6, 1);
+    return pg;
+}
+
+TEST(REORDER, ORDER_IS_PERMUTATION) {
+    haruki::Graph g(reorderTestGraph());
+
+    haruki::reorder::Strategy strategies[] = {
+        haruki::reorder::NONE,
+        haruki::reorder::BFS,
+        haruki::reorder::CUTHILL_MCKEE,
+        haruki::reorder::DEGREE
+    };
+    for (haruki::reorder::Strategy strategy : strategies) {
+        std::vector<int> order = haruki::reorder::computeOrder(g, strategy);
+        ASSERT_EQ(7, order.size());
+        std::sort(order.begin(), order.end());
+        for (int i = 0; i < 7; i++) {
+            ASSERT_EQ(i, order[i]);
+        }
+    }
+
+    std::vector<int> bfs = haruki::reorder::computeOrder(g, haruki::reorder::BFS);
+    ASSERT_EQ(0, bfs[0]);
+    ASSERT_EQ(1, bfs[1]);
+    ASSERT_EQ(2, bfs[2]);
+    ASSERT_EQ(6, bfs[6]);
+
+    std::vector<int> degree = haruki::reorder::computeOrder(g, haruki::reorder::DEGREE);
+    ASSERT_EQ(1, degree[0]);
+    ASSERT_EQ(6, degree[6]);
+}
+
+TEST(REORDER, IDS_ARE_MAPPED_BACK) {
+    haruki::Graph g(reorderTestGraph());
+    ASSERT_FALSE(g.hasOriginalIds());
+    ASSERT_EQ(3, g.toInternalId(3));
+
+    haruki::Graph *h = haruki::reorder::reorderGraph(g, haruki::reorder::DEGREE);
+    ASSERT_TRUE(h->hasOriginalIds());
+    ASSERT_EQ(7, h->getNumVert());
+    ASSERT_EQ(11, h->getNumEdges());
+    for (int v = 0; v < 7; v++) {
+        ASSERT_EQ(v, h->toOriginalId(h->toInternalId(v)));
+    }
+    ASSERT_DOUBLE_EQ(1, h->getEdgeCost(h->toInternalId(5), h->toInternalId(6)));
+    ASSERT_DOUBLE_EQ(2, h->getEdgeCost(h->toInternalId(3), h->toInternalId(2)));
+
+    /* reordering again still maps to the ids of the input */
+    haruki::Graph *h2 = haruki::reorder::reorderGraph(*h, haruki::reorder::CUTHILL_MCKEE);
+    for (int v = 0; v < 7; v++) {
+        ASSERT_EQ(v, h2->toOriginalId(h2->toInternalId(v)));
+    }
+
+    haruki::KSP<haruki::YenKSP> yen;
+    std::vector<haruki::Path> expected = yen.run(g, 0, 6, 5);
+    std::vector<haruki::Path> result = yen.run(*h2, 0, 6, 5);
+
+    ASSERT_NO_FATAL_FAILURE(assertSamePaths(expected, result));
+
+    delete h;
+    delete h2;
+}
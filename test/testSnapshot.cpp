@@ -0,0 +1,272 @@
+/*
+ * Copyright (C) 2018 Diogo Haruki Kykuta
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+*/
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include "../src/snapshot.hpp"
+#include "../src/mappedfile.hpp"
+#include "../src/reorder.hpp"
+#include "../src/graph.hpp"
+
+static std::vector<haruki::EdgeInfo> incomingEdges(haruki::Graph &g) {
+    std::vector<haruki::EdgeInfo> edges;
+    for (int v = 0; v < g.getNumVert(); v++) {
+        for (haruki::EdgeIn::iterator it = g.getEdgesIn(v).begin(); it != g.getEdgesIn(v).end(); ++it) {
+            edges.push_back(*it);
+        }
+    }
+    return edges;
+}
+
+static void expectSameEdges(const std::vector<haruki::EdgeInfo> &expected, const std::vector<haruki::EdgeInfo> &actual) {
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        ASSERT_EQ(expected[i].tail, actual[i].tail);
+        ASSERT_EQ(expected[i].head, actual[i].head);
+        ASSERT_DOUBLE_EQ(expected[i].cost, actual[i].cost);
+    }
+}
+
+TEST(SNAPSHOT, SAVE_AND_LOAD) {
+    haruki::GraphBuilder pg;
+    pg.setNumVert(6);
+    pg.addEdge(0, 1, 1.5);
+    pg.addEdge(0, 2, 2);
+    pg.addEdge(1, 3, 2);
+    pg.addEdge(2, 1, 0.25);
+    pg.addEdge(3, 4, 3);
+    pg.addEdge(4, 0, 1);
+    pg.addEdge(4, 2, 7);
+    haruki::Graph plain(pg);
+    haruki::Graph *g = haruki::reorder::reorderGraph(plain, haruki::reorder::DEGREE);
+
+    std::string path = ::testing::TempDir() + "hrk_graph.snapshot";
+    ASSERT_FALSE(haruki::snapshot::isSnapshot(path + ".missing"));
+    ASSERT_TRUE(haruki::snapshot::save(*g, path));
+    ASSERT_TRUE(haruki::snapshot::isSnapshot(path));
+
+    haruki::Graph *loaded = haruki::snapshot::load(path);
+    std::remove(path.c_str());
+    ASSERT_NE(nullptr, loaded);
+    ASSERT_EQ(6, loaded->getNumVert());
+    ASSERT_EQ(7, loaded->getNumEdges());
+    ASSERT_FALSE(loaded->isSymmetric());
+    /* the reverse index comes from the file */
+    ASSERT_EQ(7, loaded->getTopology()->reverseTrace.size());
+    expectSameEdges(g->getEdgeInfoList(), loaded->getEdgeInfoList());
+    expectSameEdges(incomingEdges(*g), incomingEdges(*loaded));
+
+    ASSERT_TRUE(loaded->hasOriginalIds());
+    for (int v = 0; v < 6; v++) {
+        ASSERT_EQ(g->toInternalId(v), loaded->toInternalId(v));
+    }
+    ASSERT_DOUBLE_EQ(0.25, loaded->getEdgeCost(loaded->toInternalId(2), loaded->toInternalId(1)));
+
+    /* the arrays read the file in place */
+    std::shared_ptr<const haruki::GraphTopology> topology = loaded->getTopology();
+    ASSERT_NE(nullptr, topology->mapping);
+    const char *begin = topology->mapping->data();
+    const char *end = begin + topology->mapping->size();
+    ASSERT_TRUE((const char *)topology->heads.data() > begin && (const char *)topology->heads.data() < end);
+    ASSERT_TRUE((const char *)topology->reverseTails.data() > begin && (const char *)topology->reverseTails.data() < end);
+    /* copies of them do not */
+    haruki::HugeVector<int> heads = topology->heads;
+    ASSERT_TRUE((const char *)heads.data() < begin || (const char *)heads.data() >= end);
+    ASSERT_EQ(topology->heads, heads);
+
+    /* costs are not written to the file, the topology is cloned first */
+    std::vector<haruki::EdgeInfo> updates;
+    updates.push_back(haruki::EdgeInfo(loaded->toInternalId(2), loaded->toInternalId(1), 9));
+    loaded->updateEdgeCosts(updates);
+    ASSERT_NE(topology, loaded->getTopology());
+    ASSERT_EQ(nullptr, loaded->getTopology()->mapping);
+    ASSERT_DOUBLE_EQ(9, loaded->getEdgeCost(loaded->toInternalId(2), loaded->toInternalId(1)));
+    ASSERT_DOUBLE_EQ(0.25, topology->costs[loaded->getEdgeIndex(loaded->toInternalId(2), loaded->toInternalId(1))]);
+    delete loaded;
+    delete g;
+}
+
+TEST(SNAPSHOT, SYMMETRIC) {
+    haruki::GraphBuilder pg;
+    pg.addEdge(0, 1, 1);
+    pg.addEdge(1, 0, 2);
+    pg.addEdge(1, 2, 3);
+    pg.addEdge(2, 1, 3);
+    haruki::Graph g(pg);
+    ASSERT_TRUE(g.useSymmetricStorage());
+
+    std::string path = ::testing::TempDir() + "hrk_symmetric.snapshot";
+    ASSERT_TRUE(haruki::snapshot::save(g, path));
+    haruki::Graph *loaded = haruki::snapshot::load(path);
+    std::remove(path.c_str());
+    ASSERT_NE(nullptr, loaded);
+    ASSERT_TRUE(loaded->isSymmetric());
+    ASSERT_TRUE(loaded->getTopology()->reverseTrace.empty());
+    ASSERT_FALSE(loaded->hasOriginalIds());
+    expectSameEdges(incomingEdges(g), incomingEdges(*loaded));
+    delete loaded;
+}
+
+TEST(SNAPSHOT, REJECTS_BAD_FILES) {
+    haruki::GraphBuilder pg;
+    pg.addEdge(0, 1, 1);
+    pg.addEdge(1, 2, 1);
+    haruki::Graph g(pg);
+
+    std::string path = ::testing::TempDir() + "hrk_bad.snapshot";
+    ASSERT_TRUE(haruki::snapshot::save(g, path));
+    std::string bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    /* truncated */
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), bytes.size() - 4);
+    }
+    ASSERT_TRUE(haruki::snapshot::isSnapshot(path));
+    ASSERT_EQ(nullptr, haruki::snapshot::load(path));
+
+    /* another version */
+    {
+        std::string other = bytes;
+        other[8] = 99;
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(other.data(), other.size());
+    }
+    ASSERT_EQ(nullptr, haruki::snapshot::load(path));
+
+    /* a text graph */
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << "p sp 2 1\na 1 2 1\n";
+    }
+    ASSERT_FALSE(haruki::snapshot::isSnapshot(path));
+    ASSERT_EQ(nullptr, haruki::snapshot::load(path));
+    std::remove(path.c_str());
+}
+
+/* overwrites the first element of a section, whose offset the header
+ * keeps at byte 40 + 8 * section */
+template <class T>
+static void corruptSection(const std::string &path, const std::string &bytes, int section, T value) {
+    std::string corrupt = bytes;
+    uint64_t offset;
+    memcpy(&offset, &corrupt[40 + 8 * section], sizeof(offset));
+    ASSERT_NE(0u, offset);
+    memcpy(&corrupt[offset], &value, sizeof(value));
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(corrupt.data(), corrupt.size());
+}
+
+TEST(SNAPSHOT, REJECTS_VALUES_OUT_OF_RANGE) {
+    haruki::GraphBuilder pg;
+    pg.setNumVert(4);
+    pg.addEdge(0, 1, 1);
+    pg.addEdge(1, 2, 1);
+    pg.addEdge(2, 3, 1);
+    pg.addEdge(3, 1, 1);
+    haruki::Graph plain(pg);
+    haruki::Graph *g = haruki::reorder::reorderGraph(plain, haruki::reorder::BFS);
+
+    std::string path = ::testing::TempDir() + "hrk_corrupt.snapshot";
+    ASSERT_TRUE(haruki::snapshot::save(*g, path));
+    int secondId = g->toOriginalId(1);
+    delete g;
+    std::string bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    haruki::Graph *loaded = haruki::snapshot::load(path);
+    ASSERT_NE(nullptr, loaded);
+    delete loaded;
+
+    /* sections: offsets, heads, costs, reverse offsets, reverse trace,
+     * reverse tails, input ids, their inverse */
+    corruptSection(path, bytes, 0, (haruki::EdgeIdx)5);
+    ASSERT_EQ(nullptr, haruki::snapshot::load(path));
+    corruptSection(path, bytes, 1, 4);
+    ASSERT_EQ(nullptr, haruki::snapshot::load(path));
+    corruptSection(path, bytes, 1, -1);
+    ASSERT_EQ(nullptr, haruki::snapshot::load(path));
+    corruptSection(path, bytes, 3, (haruki::EdgeIdx)-1);
+    ASSERT_EQ(nullptr, haruki::snapshot::load(path));
+    corruptSection(path, bytes, 4, (haruki::EdgeIdx)4);
+    ASSERT_EQ(nullptr, haruki::snapshot::load(path));
+    corruptSection(path, bytes, 5, 7);
+    ASSERT_EQ(nullptr, haruki::snapshot::load(path));
+    corruptSection(path, bytes, 6, -3);
+    ASSERT_EQ(nullptr, haruki::snapshot::load(path));
+    /* two vertices with the same input id */
+    corruptSection(path, bytes, 6, secondId);
+    ASSERT_EQ(nullptr, haruki::snapshot::load(path));
+    corruptSection(path, bytes, 7, 3);
+    ASSERT_EQ(nullptr, haruki::snapshot::load(path));
+
+    /* claims to be symmetric, 0 -> 1 has no twin: flags are at byte 20 */
+    {
+        std::string corrupt = bytes;
+        corrupt[20] = 1;
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(corrupt.data(), corrupt.size());
+    }
+    ASSERT_EQ(nullptr, haruki::snapshot::load(path));
+    std::remove(path.c_str());
+}
+
+TEST(SNAPSHOT, SAVES_THE_COSTS_OF_THE_GRAPH) {
+    haruki::GraphBuilder pg;
+    pg.addEdge(0, 1, 1);
+    pg.addEdge(1, 2, 1);
+    haruki::Graph g(pg);
+    haruki::Graph copy(g);
+    /* the topology is shared, so the costs go to the overlay of g */
+    std::vector<haruki::EdgeInfo> updates;
+    updates.push_back(haruki::EdgeInfo(1, 2, 4));
+    g.updateEdgeCosts(updates);
+
+    std::string path = ::testing::TempDir() + "hrk_costs.snapshot";
+    ASSERT_TRUE(haruki::snapshot::save(g, path));
+    haruki::Graph *loaded = haruki::snapshot::load(path);
+    ASSERT_NE(nullptr, loaded);
+    ASSERT_DOUBLE_EQ(4, loaded->getEdgeCost(1, 2));
+    delete loaded;
+
+    /* inserted edges would be lost */
+    std::vector<haruki::EdgeInfo> inserted;
+    inserted.push_back(haruki::EdgeInfo(2, 0, 1));
+    g.insertEdges(inserted);
+    ASSERT_FALSE(haruki::snapshot::save(g, path));
+    g.compactDelta();
+    ASSERT_TRUE(haruki::snapshot::save(g, path));
+    loaded = haruki::snapshot::load(path);
+    std::remove(path.c_str());
+    ASSERT_NE(nullptr, loaded);
+    ASSERT_EQ(3, loaded->getNumEdges());
+    ASSERT_DOUBLE_EQ(1, loaded->getEdgeCost(2, 0));
+    delete loaded;
+}
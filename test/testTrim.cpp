@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2018 Diogo Haruki Kykuta
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom
+ * the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+*/
+#include <gtest/gtest.h>
+#include "../src/trim.hpp"
+#include "../src/yenksp.hpp"
+#include "../src/ksp.hpp"
+#include "../src/path.hpp"
+#include "../src/graph.hpp"
+#include "testHelpers.hpp"
+
+static haruki::GraphBuilder trimTestGraph() {
+    haruki::GraphBuilder pg;
+    pg.setNumVert(9);
+    pg.addEdge(0, 1, 1);
+    pg.addEdge(0, 2, 2);
+    pg.addEdge(1, 3, 1);
+    pg.addEdge(2, 3, 2);
+    pg.addEdge(1, 2, 1);
+    pg.addEdge(3, 4, 10);
+    pg.addEdge(2, 5, 1);
+    pg.addEdge(5, 4, 20);
+    /* 6 is not reachable from 0, 7 does not reach 4, 8 neither */
+    pg.addEdge(6, 1, 1);
+    pg.addEdge(1, 7, 1);
+    pg.addEdge(7, 8, 1);
+    return pg;
+}
+
+TEST(TRIM, KEEPS_THE_CORE) {
+    haruki::Graph g(trimTestGraph());
+
+    haruki::Graph *h = haruki::trim::trimToCore(g, 0, 4);
+    ASSERT_EQ(6, h->getNumVert());
+    ASSERT_EQ(8, h->getNumEdges());
+    ASSERT_EQ(-1, h->toInternalId(6));
+    ASSERT_EQ(-1, h->toInternalId(7));
+    ASSERT_EQ(-1, h->toInternalId(8));
+    ASSERT_EQ(-1, h->toInternalId(100));
+    ASSERT_DOUBLE_EQ(20, h->getEdgeCost(h->toInternalId(5), h->toInternalId(4)));
+
+    haruki::KSP<haruki::YenKSP> yen;
+    std::vector<haruki::Path> expected = yen.run(g, 0, 4, 10);
+    std::vector<haruki::Path> result = yen.run(*h, 0, 4, 10);
+    ASSERT_EQ(5, expected.size());
+    ASSERT_NO_FATAL_FAILURE(assertSamePaths(expected, result));
+
+    /* d(0, 4) = 12, through 5 it is at least 23 */
+    haruki::Graph *bounded = haruki::trim::trimToCore(g, 0, 4, 1.5);
+    ASSERT_EQ(5, bounded->getNumVert());
+    ASSERT_EQ(-1, bounded->toInternalId(5));
+    result = yen.run(*bounded, 0, 4, 10);
+    ASSERT_EQ(3, result.size());
+    ASSERT_EQ(expected[0].getVertList(), result[0].getVertList());
+
+    delete h;
+    delete bounded;
+}
+
+TEST(TRIM, UNREACHABLE_TARGET) {
+    haruki::Graph g(trimTestGraph());
+
+    haruki::Graph *h = haruki::trim::trimToCore(g, 4, 0);
+    ASSERT_EQ(2, h->getNumVert());
+    ASSERT_EQ(0, h->getNumEdges());
+    haruki::KSP<haruki::YenKSP> yen;
+    ASSERT_EQ(yen.run(g, 4, 0, 3).size(), yen.run(*h, 4, 0, 3).size());
+    delete h;
+}